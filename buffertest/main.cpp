@@ -3,8 +3,16 @@
 #include <stdint.h>
 #include <assert.h>
 #include <pthread.h>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
 
 #include "buffer/BufferManager.h"
+#include "buffer/FrameArena.h"
+#include "buffer/PageTable.h"
 
 using namespace std;
 using namespace lsql;
@@ -16,6 +24,12 @@ unsigned threadCount;
 unsigned* threadSeed;
 volatile bool stop=false;
 
+const unsigned benchmarkOps = 1000000;
+const unsigned ioBenchmarkOps = 100000;
+const unsigned pageTableFrames = 4096;
+const unsigned pageTableRounds = 100;
+unsigned benchmarkPages;
+
 uint64_t randomPage(unsigned threadNum) {
 	// pseudo-gaussian, causes skewed access pattern
 	uint64_t page=0;
@@ -65,13 +79,209 @@ static void* readWrite(void *arg) {
 	return reinterpret_cast<void*>(count);
 }
 
+static void* fixResident(void *arg) {
+	// fix random pages which are all in memory
+	uintptr_t threadNum = reinterpret_cast<uintptr_t>(arg);
+
+	for (unsigned i=0; i<benchmarkOps; i++) {
+		BufferFrame& bf = bm->fixPage(PID(0, rand_r(&threadSeed[threadNum])%benchmarkPages), false);
+		bm->unfixPage(bf, false);
+	}
+
+	return NULL;
+}
+
+static void benchmark() {
+	// measure the throughput of page hits with 1 to threadCount threads
+	benchmarkPages = min(pagesOnDisk, pagesInRAM);
+	for (unsigned i=0; i<benchmarkPages; i++)
+		bm->unfixPage(bm->fixPage(PID(0, i), false), false);
+
+	double base = 0;
+	for (unsigned n=1; n<=threadCount; n=(n<threadCount && 2*n>threadCount) ? threadCount : 2*n) {
+		pthread_t threads[n];
+		auto start = chrono::steady_clock::now();
+
+		for (unsigned i=0; i<n; i++)
+			pthread_create(&threads[i], NULL, fixResident, reinterpret_cast<void*>(i));
+		for (unsigned i=0; i<n; i++)
+			pthread_join(threads[i], NULL);
+
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		double throughput = n * benchmarkOps / elapsed.count();
+		if (n == 1)
+			base = throughput;
+
+		cout << n << " threads: " << unsigned(throughput) << " fixes/s"
+		     << " (speedup " << throughput / base << ")" << endl;
+	}
+}
+
+template<typename Lookup>
+static double measureLookups(FrameArena& arena, Lookup lookup) {
+	// look up all pages repeatedly, returns nanoseconds per lookup
+	uint64_t found = 0;
+	auto start = chrono::steady_clock::now();
+
+	for (unsigned round=0; round<pageTableRounds; round++)
+		for (uint64_t i=0; i<arena.getCount(); i++)
+			found += lookup(arena.getFrame(i).getId()) != NULL;
+
+	chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+	assert(found == pageTableRounds * arena.getCount());
+	return elapsed.count() / found;
+}
+
+static void pageTableBenchmark() {
+	// compare page table lookups with slots chained by the page number only
+	FrameArena arena(pageTableFrames, false);
+	File<void> file;
+
+	uint16_t segmentCounts[] = {1, 256};
+	for (uint16_t segments : segmentCounts) {
+		PageTable table(arena.getCount());
+		for (uint64_t i=0; i<arena.getCount(); i++) {
+			BufferFrame& frame = arena.getFrame(i);
+			frame.reset(PID(uint16_t(i % segments), uint32_t(i / segments)), file);
+			table.getPartition(frame.getId()).insert(&frame);
+		}
+
+		double time = measureLookups(arena, [&](const PID& id) {
+			PageTable::Partition& partition = table.getPartition(id);
+			partition.lock(false);
+			BufferFrame* frame = partition.find(id);
+			partition.unlock();
+			return frame;
+		});
+
+		vector<vector<BufferFrame*>> slots(arena.getCount());
+		for (uint64_t i=0; i<arena.getCount(); i++)
+			slots[arena.getFrame(i).getId().page() & (slots.size() - 1)].push_back(&arena.getFrame(i));
+
+		double chained = measureLookups(arena, [&](const PID& id) -> BufferFrame* {
+			for (BufferFrame* frame : slots[id.page() & (slots.size() - 1)])
+				if (frame->getId() == id)
+					return frame;
+			return NULL;
+		});
+
+		cout << "page table, " << segments << " segments: " << time << " ns/lookup"
+		     << " (page number chains " << chained << " ns)" << endl;
+	}
+}
+
+static void* fixRandom(void *arg) {
+	// read or write skewed random pages, many of which are not in memory
+	uintptr_t threadNum = reinterpret_cast<uintptr_t>(arg);
+
+	for (unsigned i=0; i<ioBenchmarkOps/threadCount; i++) {
+		bool isWrite = rand_r(&threadSeed[threadNum])%128<10;
+		BufferFrame& bf = bm->fixPage(PID(0, randomPage(threadNum)), isWrite);
+		bm->unfixPage(bf, isWrite);
+	}
+
+	return NULL;
+}
+
+static uint64_t cachedBytes(const char* path) {
+	// count the bytes of a file held in the page cache of the kernel
+	int fd = open(path, O_RDONLY);
+	off_t size = lseek(fd, 0, SEEK_END);
+	long pageSize = sysconf(_SC_PAGESIZE);
+	uint64_t cached = 0;
+
+#ifdef __APPLE__
+	typedef char residency;
+#else
+	typedef unsigned char residency;
+#endif
+
+	void* data = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	if (data != MAP_FAILED) {
+		size_t pages = (size + pageSize - 1) / pageSize;
+		residency* resident = new residency[pages];
+		if (mincore(data, size, resident) == 0) {
+			for (size_t i=0; i<pages; i++)
+				cached += (resident[i] & 1) ? pageSize : 0;
+		}
+		delete[] resident;
+		munmap(data, size);
+	}
+
+	close(fd);
+	return cached;
+}
+
+static void dropCachedBytes(const char* path) {
+	// evict a file from the page cache of the kernel, if supported
+	int fd = open(path, O_RDONLY);
+	fsync(fd);
+#ifdef POSIX_FADV_DONTNEED
+	posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+	close(fd);
+}
+
+static void ioBenchmark() {
+	// compare buffered and direct I/O with a working set exceeding the frames
+	if (pagesOnDisk <= pagesInRAM) {
+		cerr << "warning: skipping iobench, as all " << pagesOnDisk
+		     << " pages fit into " << pagesInRAM << " frames" << endl;
+		return;
+	}
+
+	for (int direct=0; direct<2; direct++) {
+		BufferOptions options;
+		options.directIO = direct;
+		dropCachedBytes("0");
+
+		delete bm;
+		bm = new BufferManager(pagesInRAM, options);
+
+		pthread_t threads[threadCount];
+		auto start = chrono::steady_clock::now();
+
+		for (unsigned i=0; i<threadCount; i++)
+			pthread_create(&threads[i], NULL, fixRandom, reinterpret_cast<void*>(i));
+		for (unsigned i=0; i<threadCount; i++)
+			pthread_join(threads[i], NULL);
+
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		BufferStats::Snapshot stats = bm->getStats();
+		const LatencyHistogram& loads = stats.get(LATENCY_LOAD);
+
+		cout << (direct ? "direct" : "buffered") << ": "
+		     << unsigned(ioBenchmarkOps / elapsed.count()) << " fixes/s, "
+		     << loads.count << " loads (p99 < " << loads.getPercentile(0.99) / 1000 << " us), "
+		     << cachedBytes("0") / 1024 << " KiB cached by the kernel" << endl;
+	}
+}
+
 int main(int argc, char** argv) {
-	if (argc==4) {
+	bool bench = false;
+	bool ioBench = false;
+	BufferOptions options;
+
+	bool valid = argc>=4;
+	for (int i=4; valid && i<argc; i++) {
+		if (strcmp(argv[i], "bench")==0)
+			bench = true;
+		else if (strcmp(argv[i], "iobench")==0)
+			ioBench = true;
+		else if (strcmp(argv[i], "direct")==0)
+			options.directIO = true;
+		else if (strcmp(argv[i], "trace")==0 && i+1<argc)
+			options.traceFile = argv[++i];
+		else
+			valid = false;
+	}
+
+	if (valid) {
 		pagesOnDisk = atoi(argv[1]);
 		pagesInRAM = atoi(argv[2]);
 		threadCount = atoi(argv[3]);
 	} else {
-		cerr << "usage: " << argv[0] << " <pagesOnDisk> <pagesInRAM> <threads>" << endl;
+		cerr << "usage: " << argv[0] << " <pagesOnDisk> <pagesInRAM> <threads> [bench] [iobench] [direct] [trace <file>]" << endl;
 		exit(1);
 	}
 
@@ -79,7 +289,10 @@ int main(int argc, char** argv) {
 	for (unsigned i=0; i<threadCount; i++)
 		threadSeed[i] = i*97134;
 
-	bm = new BufferManager(pagesInRAM);
+	// report the final flush when restarting. With 'trace', the accesses of
+	// the test run are recorded, e.g. for replaytest.
+	options.reportFlush = true;
+	bm = new BufferManager(pagesInRAM, options);
 
 	pthread_t threads[threadCount];
 	pthread_attr_t pattr;
@@ -113,6 +326,7 @@ int main(int argc, char** argv) {
 	pthread_join(scanThread, NULL);
 
 	// restart buffer manager
+	BufferStats::Snapshot stats = bm->getStats();
 	delete bm;
 	bm = new BufferManager(pagesInRAM);
 
@@ -123,8 +337,15 @@ int main(int argc, char** argv) {
 		totalCountOnDisk+=reinterpret_cast<unsigned*>(bf.getData())[0];
 		bm->unfixPage(bf, false);
 	}
+	stats.print(cout);
 	if (totalCount==totalCountOnDisk) {
 		cout << "test successful" << endl;
+		if (bench) {
+			benchmark();
+			pageTableBenchmark();
+		}
+		if (ioBench)
+			ioBenchmark();
 		delete bm;
 		return 0;
 	} else {
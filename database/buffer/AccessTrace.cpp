@@ -0,0 +1,52 @@
+//
+//  AccessTrace.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "AccessTrace.h"
+
+namespace lsql {
+
+	AccessTrace::AccessTrace(const std::string& path)
+	: file(path, true), offset(0) {
+		file.allocate(0);
+		buffer.reserve(ACCESS_TRACE_BUFFER);
+	}
+
+	AccessTrace::~AccessTrace() {
+		m.lock();
+		flush();
+		m.unlock();
+	}
+
+	void AccessTrace::record(const PID& id) {
+		m.lock();
+		buffer.push_back(id.id);
+		if (buffer.size() >= ACCESS_TRACE_BUFFER)
+			flush();
+		m.unlock();
+	}
+
+	bool AccessTrace::load(const std::string& path, std::vector<PID>& trace) {
+		File<uint64_t> file(path);
+
+		std::vector<uint64_t> ids;
+		if (!file.readVector(ids, file.size() / sizeof(uint64_t)))
+			return false;
+
+		trace.assign(ids.begin(), ids.end());
+		return true;
+	}
+
+	void AccessTrace::flush() {
+		off_t size = buffer.size() * sizeof(uint64_t);
+		if (file.write(buffer.data(), size, offset))
+			offset += size;
+
+		buffer.clear();
+	}
+
+}
@@ -0,0 +1,85 @@
+//
+//  AccessTrace.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils/File.h"
+#include "utils/Mutex.h"
+#include "common/IDs.h"
+
+#define ACCESS_TRACE_BUFFER 4096
+
+namespace lsql {
+
+	/**
+	 * Records the sequence of pages requested from a buffer manager.
+	 *
+	 * The trace file is a plain array of 64 bit page ids in access order. It
+	 * can be loaded again to replay the accesses, for instance to compare page
+	 * replacement policies. Accesses of concurrent threads are interleaved.
+	 */
+	class AccessTrace {
+
+		Mutex m;
+		File<uint64_t> file;
+		std::vector<uint64_t> buffer;
+		off_t offset;
+
+	public:
+
+		/**
+		 * Creates a new trace at the given location. An existing file is
+		 * truncated.
+		 *
+		 * @param path The path of the trace file.
+		 */
+		explicit AccessTrace(const std::string& path);
+
+		/** Prevent the copy constructor. */
+		AccessTrace(const AccessTrace& other) = delete;
+
+		/** Prevent copy assignments. */
+		AccessTrace& operator=(const AccessTrace& other) = delete;
+
+		/**
+		 * Writes all remaining accesses and closes the trace.
+		 */
+		~AccessTrace();
+
+		/**
+		 * Appends an access to the trace.
+		 *
+		 * @param id The page which has been requested.
+		 */
+		void record(const PID& id);
+
+		/**
+		 * Reads a trace file created by this class.
+		 *
+		 * @param path  The path of the trace file.
+		 * @param trace Receives the accessed pages in order.
+		 *
+		 * @return True if the trace has been read; otherwise false.
+		 */
+		static bool load(const std::string& path, std::vector<PID>& trace);
+
+	private:
+
+		/**
+		 * Writes all buffered accesses to the file. The mutex has to be held
+		 * by the caller.
+		 */
+		void flush();
+
+	};
+
+}
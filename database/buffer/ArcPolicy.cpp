@@ -0,0 +1,204 @@
+//
+//  ArcPolicy.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <algorithm>
+#include <cassert>
+
+#include "ArcPolicy.h"
+
+#define ARC_NO_GHOST UINT32_MAX
+
+namespace lsql {
+
+	ArcPolicy::ArcPolicy(uint64_t size)
+	: capacity(size), target(0), ghosts(size), freeGhost(0) {
+		assert(size > 0 && size < ARC_NO_GHOST);
+
+		uint64_t bucketCount = 1;
+		while (bucketCount < size)
+			bucketCount <<= 1;
+		buckets.assign(bucketCount, ARC_NO_GHOST);
+
+		for (uint32_t i = 0; i < size; ++i)
+			ghosts[i].next = (i + 1 < size) ? i + 1 : ARC_NO_GHOST;
+
+		for (int list = 0; list < GHOST_LISTS; ++list) {
+			ghostFirst[list] = ghostLast[list] = ARC_NO_GHOST;
+			ghostSize[list] = 0;
+		}
+	}
+
+	const char* ArcPolicy::getName() const {
+		return "ARC";
+	}
+
+	void ArcPolicy::insert(BufferFrame* frame) {
+		queueT1.lock(true);
+
+		// Adapt the target size of T1 on ghost hits
+		uint32_t ghost = findGhost(getKey(frame->getId()));
+		if (ghost == ARC_NO_GHOST) {
+			frame->queue = QUEUE_A1;
+			queueT1.prepend(frame);
+		} else {
+			uint64_t b1 = ghostSize[GHOST_B1];
+			uint64_t b2 = ghostSize[GHOST_B2];
+
+			if (ghosts[ghost].list == GHOST_B1) {
+				target = std::min(capacity, target + std::max<uint64_t>(1, b2 / b1));
+			} else {
+				uint64_t delta = std::max<uint64_t>(1, b1 / b2);
+				target = (target > delta) ? target - delta : 0;
+			}
+
+			removeGhost(ghost);
+			frame->queue = QUEUE_AM;
+			queueT2.prepend(frame);
+		}
+
+		queueT1.unlock();
+	}
+
+	void ArcPolicy::access(BufferFrame* frame) {
+		queueT1.lock(true);
+
+		if (frame->queue == QUEUE_A1) {
+			queueT1.remove(frame);
+			frame->queue = QUEUE_AM;
+			queueT2.prepend(frame);
+		} else if (frame->queue == QUEUE_AM) {
+			queueT2.bringFront(frame);
+		}
+
+		queueT1.unlock();
+	}
+
+	BufferFrame* ArcPolicy::evict(FrameEvictor& evictor) {
+		queueT1.lock(true);
+
+		BufferFrame* frame = nullptr;
+		bool preferT1 = queueT1.getSize() > target;
+
+		if (preferT1 || queueT2.getSize() == 0) {
+			frame = evictLast(queueT1, evictor);
+			if (frame != nullptr)
+				addGhost(getKey(frame->getId()), GHOST_B1);
+		}
+
+		if (frame == nullptr) {
+			frame = evictLast(queueT2, evictor);
+			if (frame != nullptr)
+				addGhost(getKey(frame->getId()), GHOST_B2);
+		}
+
+		if (frame == nullptr && !preferT1) {
+			frame = evictLast(queueT1, evictor);
+			if (frame != nullptr)
+				addGhost(getKey(frame->getId()), GHOST_B1);
+		}
+
+		queueT1.unlock();
+		return frame;
+	}
+
+	bool ArcPolicy::discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor) {
+		// Scanned pages are not remembered in B1
+		queueT1.lock(true);
+		bool removed = frame->queue == QUEUE_A1 && evictFrame(queueT1, frame, id, evictor);
+		queueT1.unlock();
+
+		return removed;
+	}
+
+	void ArcPolicy::collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget) {
+		queueT1.lock(false);
+		collectLast(queueT1, frames, window, budget);
+		collectLast(queueT2, frames, window, budget);
+		queueT1.unlock();
+	}
+
+	void ArcPolicy::collectPages(std::vector<PID>& pages) {
+		queueT1.lock(false);
+		collectFirst(queueT2, pages);
+		collectFirst(queueT1, pages);
+		queueT1.unlock();
+	}
+
+	uint64_t ArcPolicy::getKey(const PID& id) {
+		// Compare like operator==, which ignores the tuple bits
+		return id.id >> 16;
+	}
+
+	uint32_t& ArcPolicy::getBucket(uint64_t id) {
+		// Fibonacci hashing spreads consecutive pages over all buckets
+		return buckets[(id * 0x9E3779B97F4A7C15ull >> 32) & (buckets.size() - 1)];
+	}
+
+	uint32_t ArcPolicy::findGhost(uint64_t id) {
+		uint32_t index = getBucket(id);
+		while (index != ARC_NO_GHOST && ghosts[index].id != id)
+			index = ghosts[index].chain;
+
+		return index;
+	}
+
+	void ArcPolicy::addGhost(uint64_t id, GhostList list) {
+		// T1 and B1 together never exceed the capacity
+		if (list == GHOST_B1 && ghostSize[GHOST_B1] > 0 && queueT1.getSize() + ghostSize[GHOST_B1] >= capacity)
+			removeGhost(ghostLast[GHOST_B1]);
+
+		// Otherwise, forget the oldest page of B2 first
+		if (freeGhost == ARC_NO_GHOST)
+			removeGhost(ghostLast[ghostSize[GHOST_B2] > 0 ? GHOST_B2 : GHOST_B1]);
+
+		uint32_t index = freeGhost;
+		Ghost& ghost = ghosts[index];
+		freeGhost = ghost.next;
+
+		uint32_t& bucket = getBucket(id);
+		ghost.id = id;
+		ghost.chain = bucket;
+		bucket = index;
+
+		ghost.list = list;
+		ghost.prev = ARC_NO_GHOST;
+		ghost.next = ghostFirst[list];
+		if (ghost.next != ARC_NO_GHOST)
+			ghosts[ghost.next].prev = index;
+		else
+			ghostLast[list] = index;
+
+		ghostFirst[list] = index;
+		ghostSize[list]++;
+	}
+
+	void ArcPolicy::removeGhost(uint32_t index) {
+		Ghost& ghost = ghosts[index];
+
+		uint32_t* link = &getBucket(ghost.id);
+		while (*link != index)
+			link = &ghosts[*link].chain;
+		*link = ghost.chain;
+
+		if (ghost.prev != ARC_NO_GHOST)
+			ghosts[ghost.prev].next = ghost.next;
+		else
+			ghostFirst[ghost.list] = ghost.next;
+
+		if (ghost.next != ARC_NO_GHOST)
+			ghosts[ghost.next].prev = ghost.prev;
+		else
+			ghostLast[ghost.list] = ghost.prev;
+
+		ghostSize[ghost.list]--;
+
+		ghost.next = freeGhost;
+		freeGhost = index;
+	}
+
+}
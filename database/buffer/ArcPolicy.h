@@ -0,0 +1,112 @@
+//
+//  ArcPolicy.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ReplacementPolicy.h"
+
+namespace lsql {
+
+	/**
+	 * Adaptive replacement cache (ARC) by Megiddo and Modha.
+	 *
+	 * Frames accessed once are kept in the LRU queue T1, frames accessed more
+	 * often in the LRU queue T2. The ids of pages paged out from these queues
+	 * are remembered in the ghost lists B1 and B2, respectively. A miss on a
+	 * page in a ghost list shifts the target size of T1 in favor of the list
+	 * that would have kept the page.
+	 *
+	 * The ghost lists are stored in a preallocated directory, so tracking them
+	 * does not allocate memory. Both queues and the directory are guarded by
+	 * the latch of queue T1.
+	 */
+	class ArcPolicy : public ReplacementPolicy {
+
+		/**
+		 * The ids of the ghost lists B1 and B2.
+		 */
+		enum GhostList {
+			GHOST_B1 = 0,
+			GHOST_B2,
+			GHOST_LISTS
+		};
+
+		/**
+		 * An entry of the ghost directory. Entries are linked into their list
+		 * and into a hash chain by index.
+		 */
+		struct Ghost {
+			uint64_t id;
+			uint32_t prev;
+			uint32_t next;
+			uint32_t chain;
+			GhostList list;
+		};
+
+		uint64_t capacity;
+		uint64_t target;
+		FrameQueue queueT1;
+		FrameQueue queueT2;
+
+		std::vector<Ghost> ghosts;
+		std::vector<uint32_t> buckets;
+		uint32_t freeGhost;
+		uint32_t ghostFirst[GHOST_LISTS];
+		uint32_t ghostLast[GHOST_LISTS];
+		uint64_t ghostSize[GHOST_LISTS];
+
+	public:
+
+		/**
+		 * Creates a new policy.
+		 *
+		 * @param size The number of frames in the buffer manager.
+		 */
+		explicit ArcPolicy(uint64_t size);
+
+		const char* getName() const;
+		void insert(BufferFrame* frame);
+		void access(BufferFrame* frame);
+		BufferFrame* evict(FrameEvictor& evictor);
+		bool discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor);
+		void collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget);
+		void collectPages(std::vector<PID>& pages);
+
+	private:
+
+		/**
+		 * Returns the key of a page in the ghost directory. Tuple bits are
+		 * dropped, as frames may carry ids built from TIDs.
+		 */
+		static uint64_t getKey(const PID& id);
+
+		/**
+		 * Returns the hash chain of the given page key.
+		 */
+		uint32_t& getBucket(uint64_t id);
+
+		/**
+		 * Returns the index of the ghost entry of a page, or @c ARC_NO_GHOST.
+		 */
+		uint32_t findGhost(uint64_t id);
+
+		/**
+		 * Remembers the id of a page paged out from T1 or T2.
+		 */
+		void addGhost(uint64_t id, GhostList list);
+
+		/**
+		 * Removes a ghost entry from its list and the directory.
+		 */
+		void removeGhost(uint32_t index);
+
+	};
+
+}
@@ -6,42 +6,52 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <algorithm>
+#include <cassert>
 #include <cstdlib>
 #include <unistd.h>
-#include <sys/sysctl.h>
-#include <sstream>
 
-#include "utils/File.h"
 #include "BufferFrame.h"
 
 namespace lsql {
 
 	size_t BufferFrame::SIZE = BUFFER_FRAME_SIZE * (size_t) sysconf(_SC_PAGESIZE);
 
-	BufferFrame::BufferFrame(const PID& id)
-	: id(id), dirty(false), queue(QUEUE_NONE) {
-		tableNext = tablePrev = nullptr;
+	BufferFrame::BufferFrame(const PID& id, File<void>& file)
+	: id(id), file(&file), size(SIZE), ownsData(true), dirty(false), version(0), queue(QUEUE_NONE), fixCount(0), readAhead(READ_AHEAD_NONE), referenced(false), heapIndex(0) {
 		queueNext = queuePrev = nullptr;
+		std::fill_n(history, BUFFER_FRAME_HISTORY, 0);
 
 		// use valloc over malloc for aligned memory pages.
 		data = valloc(SIZE);
 		assert(data != nullptr);
 	}
 
-	BufferFrame::BufferFrame(const PID& id, BufferFrame&& unused)
-	: id(id), dirty(false), queue(QUEUE_NONE) {
-		tableNext = tablePrev = nullptr;
+	BufferFrame::BufferFrame(void* data, size_t size)
+	: id(0), file(nullptr), data(data), size(size), ownsData(false), dirty(false), version(0), queue(QUEUE_NONE), fixCount(0), readAhead(READ_AHEAD_NONE), referenced(false), heapIndex(0) {
 		queueNext = queuePrev = nullptr;
-
-		data = unused.getData();
-		unused.invalidate();
+		std::fill_n(history, BUFFER_FRAME_HISTORY, 0);
 	}
 
 	BufferFrame::~BufferFrame() {
-		if (data != nullptr) {
+		if (file != nullptr)
 			save();
+
+		if (ownsData)
 			free(data);
-		}
+	}
+
+	void BufferFrame::reset(const PID& id, File<void>& file) {
+		assert(fixCount == 0 && !dirty);
+
+		this->id = id;
+		this->file = &file;
+
+		queueNext = queuePrev = nullptr;
+		queue = QUEUE_NONE;
+		readAhead = READ_AHEAD_NONE;
+		referenced = false;
+		std::fill_n(history, BUFFER_FRAME_HISTORY, 0);
 	}
 
 	const PID& BufferFrame::getId() const {
@@ -52,46 +62,83 @@ namespace lsql {
 		return data;
 	}
 
+	size_t BufferFrame::getSize() const {
+		return size;
+	}
+
 	bool BufferFrame::isDirty() const {
 		return dirty;
 	}
 
-	void BufferFrame::setDirty() {
-		dirty = true;
+	uint64_t BufferFrame::getVersion() const {
+		return version;
 	}
 
-	bool BufferFrame::load() {
-		std::string fileName = std::to_string(id.segment());
-		File<void> file(fileName, false);
+	bool BufferFrame::setDirty() {
+		return !dirty.exchange(true);
+	}
 
-		return file.read(data, SIZE, id.page() * SIZE);
+	bool BufferFrame::setClean() {
+		return dirty.exchange(false);
+	}
+
+	bool BufferFrame::load() {
+		return file->read(data, size, off_t(id.page()) * size) >= 0;
 	}
 
 	bool BufferFrame::save() {
 		if (!dirty)
 			return true;
 
-		std::string fileName = std::to_string(id.segment());
-		File<void> file(fileName, true);
+		if (!file->write(data, size, off_t(id.page()) * size))
+			return false;
 
-		return file.write(data, SIZE, id.page() * SIZE);
 		dirty = false;
+		return true;
 	}
 
 	bool BufferFrame::lock(bool exclusive) {
-		return l.lock(exclusive);
+		if (!l.lock(exclusive))
+			return false;
+
+		if (exclusive)
+			version++;
+
+		return true;
 	}
 
 	bool BufferFrame::tryLock(bool exclusive) {
-		return l.tryLock(exclusive);
+		if (!l.tryLock(exclusive))
+			return false;
+
+		if (exclusive)
+			version++;
+
+		return true;
 	}
 
-	bool BufferFrame::unlock() {
-		return l.unlock();
+	bool BufferFrame::lockUpdate() {
+		return l.lockUpdate();
+	}
+
+	bool BufferFrame::tryLockUpdate() {
+		return l.tryLockUpdate();
+	}
+
+	bool BufferFrame::upgrade() {
+		if (!l.upgrade())
+			return false;
+
+		version++;
+		return true;
 	}
 
-	void BufferFrame::invalidate() {
-		this->data = nullptr;
+	bool BufferFrame::unlock() {
+		// Only exclusive locks leave an odd version
+		if (version & 1)
+			version++;
+
+		return l.unlock();
 	}
 
 }
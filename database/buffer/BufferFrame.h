@@ -8,16 +8,22 @@
 
 #pragma once
 
-#include "utils/Lock.h"
+#include <atomic>
+
+#include "utils/File.h"
+#include "utils/Latch.h"
 #include "common/IDs.h"
 
 #define BUFFER_FRAME_SIZE 8
+#define BUFFER_FRAME_HISTORY 2
 
 namespace lsql {
 
 	/**
-	 * The type of queue this frame is currently stored in. This belongs to the 
-	 * 2Q page replaement algorithm. See @c BufferManager for more information.
+	 * The type of queue this frame is currently stored in. Replacement policies
+	 * keep frames accessed once in @c QUEUE_A1, and frames which have been
+	 * accessed again in @c QUEUE_AM. See @c ReplacementPolicy for more
+	 * information.
 	 */
 	enum QueueType {
 		QUEUE_NONE = 0,
@@ -25,6 +31,17 @@ namespace lsql {
 		QUEUE_AM
 	};
 
+	/**
+	 * Read ahead information of a frame. Pages loaded by read ahead are not
+	 * considered as accessed until they are fixed for the first time. See
+	 * @c BufferManager::prefetch for more information.
+	 */
+	enum ReadAheadState {
+		READ_AHEAD_NONE = 0,
+		READ_AHEAD_PAGE,
+		READ_AHEAD_MARKER
+	};
+
 	/**
 	 * Contains information about one page managed by a buffer manager.
 	 */
@@ -32,23 +49,23 @@ namespace lsql {
 
 		// Frame data
 		PID id;
-		Lock l;
+		File<void>* file;
+		Latch l;
 		void* data;
-		bool dirty;
+		size_t size;
+		bool ownsData;
+		std::atomic<bool> dirty;
+		std::atomic<uint64_t> version;
 
 	public:
 
 		/**
-		 * The size of BufferFrame data arrays. Typically 4096.
+		 * The default size of BufferFrame data arrays. Typically 32 KiB.
+		 * Segments can use other page sizes, see
+		 * @c BufferManager::setPageSize.
 		 */
 		static size_t SIZE;
 
-		/** Internal pointer for buffer management. */
-		BufferFrame* tableNext;
-
-		/** Internal pointer for buffer management. */
-		BufferFrame* tablePrev;
-
 		/** Queue type information for page replacement. */
 		QueueType queue;
 
@@ -57,15 +74,34 @@ namespace lsql {
 
 		/** Internal pointer for page replacement. */
 		BufferFrame* queuePrev;
+
+		/**
+		 * The number of threads currently fixing this frame. A frame is only
+		 * paged out by the buffer manager, if it is not fixed by any thread.
+		 */
+		std::atomic<uint32_t> fixCount;
+
+		/** Read ahead information for sequential scans. */
+		std::atomic<ReadAheadState> readAhead;
+
+		/** Reference bit for CLOCK and 2Q page replacement. */
+		std::atomic<bool> referenced;
+
+		/** The most recent logical access times for LRU-K page replacement. */
+		std::atomic<uint64_t> history[BUFFER_FRAME_HISTORY];
+
+		/** Position in the heap of LRU-K page replacement. */
+		uint64_t heapIndex;
 		
 		/**
 		 * Creates a new buffer frame and allocates enough space to fit
 		 * @c BufferFrame::SIZE byte pages. Initially, the frame is not
 		 * dirty.
 		 *
-		 * @param id A unique identifier for this page frame.
+		 * @param id   A unique identifier for this page frame.
+		 * @param file The open file of the segment containing this page.
 		 */
-		BufferFrame(const PID& id);
+		BufferFrame(const PID& id, File<void>& file);
 
 		/** Prevent the copy constructor. */
 		BufferFrame(const BufferFrame& other) = delete;
@@ -74,24 +110,37 @@ namespace lsql {
 		BufferFrame& operator=(const BufferFrame& other) = delete;
 
 		/**
-		 * Creates a new buffer frame and inherits the memory pages of
-		 * that frame. The reference to the memory page is removed from 
-		 * the old frame.
+		 * Creates an unassigned buffer frame on top of existing memory, which
+		 * must be large enough to fit a page. The memory is not released by
+		 * the frame. Use @c reset to assign a page to the frame.
 		 *
-		 * This method might fail, if the old frame is dirty and there
-		 * is data which has not been written to disk.
+		 * For direct I/O, the memory must be aligned to
+		 * @c FILE_DIRECT_ALIGNMENT bytes.
 		 *
-		 * @param id     A unique identifier for this page frame.
-		 * @param unused An old buffer frame to take over.
+		 * @param data A pointer to @c size bytes of memory.
+		 * @param size The size of pages in this frame.
 		 */
-		BufferFrame(const PID& id, BufferFrame&& unused);
+		explicit BufferFrame(void* data, size_t size = SIZE);
 
 		/**
 		 * Destroys this buffer frame and releases all memory allocated
-		 * by it. This effectively removes all data stored in this frame.
+		 * by it. Dirty data is written to disc before.
 		 */
 		~BufferFrame();
 
+		/**
+		 * Assigns the frame to another page, so that the frame and its memory
+		 * can be reused without allocations. The frame must neither be fixed
+		 * nor dirty, and it must not be contained in any list. Its version is
+		 * retained, so it keeps increasing over the lifetime of the frame.
+		 *
+		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
+		 *
+		 * @param id   The identifier of the new page.
+		 * @param file The open file of the segment containing this page.
+		 */
+		void reset(const PID& id, File<void>& file);
+
 		/**
 		 * Returns the id of this frame.
 		 */
@@ -104,22 +153,52 @@ namespace lsql {
 		 */
 		void* getData() const;
 
+		/**
+		 * Returns the size of the data owned by this frame in bytes. All pages
+		 * of a segment have the same size.
+		 */
+		size_t getSize() const;
+
 		/**
 		 * Returns whether this frame is dirty or not.
 		 */
 		bool isDirty() const;
 
+		/**
+		 * Returns the current version of this frame for optimistic reads.
+		 *
+		 * The version is incremented whenever an exclusive lock is acquired or
+		 * released. Thus, it is odd while the frame is locked exclusively, and
+		 * data read without a lock is only valid if the version is even and has
+		 * not changed after reading.
+		 */
+		uint64_t getVersion() const;
+
 		/**
 		 * Marks this page frame as dirty. When the frame is paged out
 		 * by the responsible BufferManager, its contents will be written
 		 * to disc.
 		 *
 		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
+		 *
+		 * @return True if the frame has been clean before; otherwise false.
 		 */
-		void setDirty();
+		bool setDirty();
+
+		/**
+		 * Marks this page frame as clean after its contents have been written
+		 * to disc by the responsible BufferManager. The frame must be locked.
+		 *
+		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
+		 *
+		 * @return True if the frame has been dirty before; otherwise false.
+		 */
+		bool setClean();
 
 		/**
 		 * Reads data of the specified page from disc into the page frame.
+		 * If the segment file uses direct I/O, the data is transferred
+		 * without passing through the page cache of the operating system.
 		 *
 		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
 		 */
@@ -142,9 +221,9 @@ namespace lsql {
 		 *  1. An exclusive lock, if @c exclusive is false.
 		 *  2. Any lock mode, if @c exclusive is true.
 		 *
-		 * Once locked, a page should not be locked again. Upgrading locks from
-		 * shared to exclusive is not possible -- instead the current lock has
-		 * to be released and a new (exclusive) lock to be acquired.
+		 * Once locked, a page should not be locked again. Shared locks cannot
+		 * be upgraded to exclusive locks. Lock the page with @c lockUpdate
+		 * instead, if it might have to be modified later.
 		 *
 		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
 		 *
@@ -161,9 +240,9 @@ namespace lsql {
 		 *  1. An exclusive lock, if @c exclusive is false.
 		 *  2. Any lock mode, if @c exclusive is true.
 		 *
-		 * Once locked, a page should not be locked again. Upgrading locks from
-		 * shared to exclusive is not possible -- instead the current lock has
-		 * to be released and a new (exclusive) lock to be acquired.
+		 * Once locked, a page should not be locked again. Shared locks cannot
+		 * be upgraded to exclusive locks. Lock the page with @c lockUpdate
+		 * instead, if it might have to be modified later.
 		 *
 		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
 		 *
@@ -173,30 +252,46 @@ namespace lsql {
 		bool tryLock(bool exclusive);
 
 		/**
-		 * Unlocks the previously locked page.
+		 * Locks this page in update mode. Other threads can still lock the
+		 * page shared, but not in update or exclusive mode. See @c Latch.
 		 *
-		 * If this thread holds no more locks on this page, another waiting
-		 * thread can acquire the lock. For more information, see @c
-		 * pthread_rwlock_unlock().
+		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
+		 *
+		 * @return True if the lock could be acquired; otherwise false.
+		 */
+		bool lockUpdate();
+
+		/**
+		 * Tries to lock this page in update mode. See @c lockUpdate.
 		 *
 		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
 		 *
-		 * @return True if the lock has been released; otherwise false.
+		 * @return True if the lock could be acquired; otherwise false.
 		 */
-		bool unlock();
+		bool tryLockUpdate();
 
-	private:
+		/**
+		 * Converts the update lock of this thread into an exclusive lock,
+		 * waiting for all shared locks to be released.
+		 *
+		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
+		 *
+		 * @return True if the lock has been upgraded; otherwise false.
+		 */
+		bool upgrade();
 
 		/**
-		 * Detaches this buffer frame from the underlying memory page. 
+		 * Unlocks the previously locked page.
 		 *
-		 * After calling this method, the frame can safely be destroyed without the 
-		 * underlying memory data to be destroyed. However, if this frame is dirty,
-		 * data is not written to disk and might be lost.
+		 * If this thread holds no more locks on this page, another waiting
+		 * thread can acquire the lock. For more information, see @c
+		 * pthread_rwlock_unlock().
 		 *
 		 * THIS METHOD SHOULD ONLY BE USED BY THE OWNING @c Buffermanager.
+		 *
+		 * @return True if the lock has been released; otherwise false.
 		 */
-		void invalidate();
+		bool unlock();
 
 	};
 
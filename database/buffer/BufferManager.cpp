@@ -6,154 +6,954 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <algorithm>
 #include <utility>
-#include <cmath>
+#include <chrono>
+#include <vector>
+#include <unistd.h>
 
-#include "utils/File.h"
 #include "BufferManager.h"
+#include "ArcPolicy.h"
+#include "ClockPolicy.h"
+#include "LruKPolicy.h"
+#include "TwoQueuePolicy.h"
 
 namespace lsql {
 
-	BufferManager::BufferManager(uint64_t size) : freePages(size) {
-		assert(freePages > 0);
+	/**
+	 * Orders frames by segment and page number.
+	 */
+	static bool comparePages(BufferFrame* a, BufferFrame* b) {
+		PID x = a->getId(), y = b->getId();
+		return x.segment() < y.segment() || (x.segment() == y.segment() && x.page() < y.page());
+	}
 
-		queueThreshold = BUFFER_MANAGER_QUEUE_THRESHOLD * size;
-		// TODO: Come up with something better than log2(float)
-		slotCount = uint64_t(1) << int(ceil(log2(size)));
-		pageTable = new Slot[slotCount];
+	/**
+	 * Returns the number of frames in all pools.
+	 */
+	static uint64_t countFrames(uint64_t size, const BufferOptions& options) {
+		for (const PoolOptions& pool : options.pools)
+			size += pool.frames;
+		return size;
 	}
 
-	BufferManager::~BufferManager() {
-		for (; slotCount > 0; --slotCount)
-			pageTable[slotCount - 1].cleanup();
+	BufferManager::BufferManager(uint64_t size, const BufferOptions& options)
+	: dirtyPages(0), stalledThreads(0), stallTimeout(options.stallTimeout), stopping(false), files(options.directIO), pageTable(countFrames(size, options)), mapping(nullptr), mappedPages(0), trace(nullptr), frameCount(countFrames(size, options)) {
+		// The default pool comes first, so it is found first
+		pools.push_back(new FramePool(size, options.hugePages, BufferFrame::SIZE));
+		for (const PoolOptions& pool : options.pools) {
+			assert(pool.pageSize % sysconf(_SC_PAGESIZE) == 0 && getPool(pool.pageSize) == nullptr);
+			pools.push_back(new FramePool(pool.frames, options.hugePages, pool.pageSize));
+		}
+
+		bool writer = false;
+		for (FramePool* pool : pools) {
+			for (uint64_t i = 0; i < pool->arena.getCount(); ++i)
+				pool->freeFrames.append(&pool->arena.getFrame(i));
+
+			pool->policy = createPolicy(options, pool->arena.getCount());
+			pool->cleanTarget = uint64_t(options.cleanRatio * pool->arena.getCount());
+			writer = writer || pool->cleanTarget > 0;
+		}
+
+		if (!options.traceFile.empty())
+			trace = new AccessTrace(options.traceFile);
+
+		if (options.mapped)
+			mapping = new PageMapping(files, options.mappedPages);
+
+		flushBatch = std::max<uint64_t>(1, options.flushRate * BUFFER_WRITER_INTERVAL / 1000000);
+		flushThreads = options.flushThreads;
+		reportFlush = options.reportFlush;
+		manifestFile = options.manifestFile;
+		manifestInterval = options.manifestInterval;
 
-		delete[] pageTable;
+		// Never read ahead more than a quarter of the pool. In mapped mode,
+		// the operating system reads ahead and writes pages back.
+		readAheadPages = (mapping == nullptr) ? std::min<uint64_t>(options.readAheadPages, size / 4) : 0;
+
+		pthread_t thread;
+		if (mapping == nullptr && options.flushRate > 0 && writer) {
+			int rc = pthread_create(&thread, nullptr, &runWriter, this);
+			assert(rc == 0);
+			workers.push_back(thread);
+		}
+
+		for (unsigned i = 0; readAheadPages > 0 && i < options.readAheadThreads; ++i) {
+			int rc = pthread_create(&thread, nullptr, &runReadAhead, this);
+			assert(rc == 0);
+			workers.push_back(thread);
+		}
+
+		// Only the hottest pages of the last run fit into a smaller buffer
+		warming = mapping == nullptr && !manifestFile.empty() && PageManifest::load(manifestFile, warmupPages) && !warmupPages.empty();
+		if (warming) {
+			if (warmupPages.size() > frameCount)
+				warmupPages.erase(warmupPages.begin() + frameCount, warmupPages.end());
+
+			int rc = pthread_create(&thread, nullptr, &runWarmup, this);
+			assert(rc == 0);
+			workers.push_back(thread);
+		}
 	}
 
-	BufferFrame& BufferManager::fixPage(const PID& id, bool exclusive) {
-		mutex.lock();
+	BufferManager::~BufferManager() {
+		stopping = true;
 
-		BufferFrame* frame;
-		Slot& slot = getSlot(id);
+		writerMutex.lock();
+		writerCondition.broadcast();
+		writerMutex.unlock();
 
-		// Search for the frame
-		frame = acquirePage(slot, id);
-		if (frame != nullptr) {
-			frame->lock(exclusive);
-			mutex.unlock();
-			return *frame;
+		readAheadMutex.lock();
+		readAheadCondition.broadcast();
+		readAheadMutex.unlock();
+
+		for (pthread_t thread : workers)
+			pthread_join(thread, nullptr);
+
+		if (!manifestFile.empty())
+			saveManifest();
+
+		// Dirty frames are written in page order first. Frames dirtied later
+		// are written back when the pools are destroyed, which happens before
+		// the segment files are closed.
+		FlushReport report = checkpoint();
+		if (reportFlush) {
+			std::cout << "Flushed " << report.bytes << " bytes in "
+			          << report.time / 1000.0 << " ms" << std::endl;
 		}
 
-		// Create and insert a new frame
-		frame = allocatePage(slot, id);
-		mutex.unlock();
+		delete mapping;
+		delete trace;
 
-		// Load data into the new frame
-		frame->load();
+		for (FramePool* pool : pools) {
+			delete pool->policy;
+			delete pool;
+		}
+	}
 
-		// Downgrade the lock, if only a shared lock is desired
-		if (!exclusive) {
-			frame->unlock();
+	bool BufferManager::setPageSize(uint16_t segment, size_t pageSize) {
+		if (getPool(pageSize) == nullptr)
+			return false;
+
+		if (files.getPageSize(segment) == pageSize)
+			return true;
+
+		// Resident frames have been read with the old page size
+		if (hasResidentPages(segment))
+			return false;
+
+		files.setPageSize(segment, pageSize);
+		return true;
+	}
+
+	size_t BufferManager::getPageSize(uint16_t segment) {
+		return files.getPageSize(segment);
+	}
+
+	BufferFrame& BufferManager::fixPage(const PID& id, bool exclusive, BufferRing* ring) {
+		BufferFrame* frame = requestPage(id, ring, stallTimeout, exclusive);
+		if (frame == nullptr)
+			throw BufferStallError();
+
+		lockFrame(frame, exclusive);
+		return *frame;
+	}
+
+	BufferFrame* BufferManager::tryFixPage(const PID& id, bool exclusive, uint64_t timeout) {
+		BufferFrame* frame = requestPage(id, nullptr, timeout, exclusive);
+		if (frame != nullptr)
+			lockFrame(frame, exclusive);
+
+		return frame;
+	}
+
+	BufferFrame& BufferManager::fixPageUpdate(const PID& id) {
+		BufferFrame* frame = requestPage(id, nullptr, stallTimeout, true);
+		if (frame == nullptr)
+			throw BufferStallError();
+
+		lockFrame(frame, false, true);
+		return *frame;
+	}
+
+	void BufferManager::upgradePage(BufferFrame& frame) {
+		uint64_t start = BufferStats::now();
+		frame.upgrade();
+		stats.record(LATENCY_LOCK_WAIT, BufferStats::now() - start);
+	}
+
+	void BufferManager::unfixPage(BufferFrame& frame, bool isDirty) {
+		if (isDirty && frame.setDirty())
+			dirtyPages++;
+
+		frame.unlock();
+		unpinPage(&frame);
+	}
+
+	void BufferManager::refixPage(BufferFrame& frame) {
+		frame.fixCount++;
+		lockFrame(&frame, false);
+	}
+
+	BufferFrame& BufferManager::fixPageOptimistic(const PID& id, uint64_t& version) {
+		BufferFrame* frame = requestPage(id, nullptr, stallTimeout, false);
+		if (frame == nullptr)
+			throw BufferStallError();
+
+		// Block until a concurrent writer has released the frame
+		version = frame->getVersion();
+		while (version & 1) {
 			frame->lock(false);
+			version = frame->getVersion();
+			frame->unlock();
 		}
 
 		return *frame;
 	}
 
-	void BufferManager::unfixPage(BufferFrame& frame, bool isDirty) {
-		if (isDirty)
-			frame.setDirty();
+	void BufferManager::prefetch(const PID& first, uint32_t count) {
+		if (mapping != nullptr && count > 0) {
+			mapping->prefetch(first, count);
+			return;
+		}
+
+		if (count == 0 || readAheadPages == 0)
+			return;
+
+		readAheadMutex.lock();
+
+		// Drop hints if the I/O threads cannot keep up
+		if (readAheadRequests.size() < BUFFER_READ_AHEAD_QUEUE) {
+			readAheadRequests.push_back(std::make_pair(first, count));
+			readAheadCondition.signal();
+		}
+
+		readAheadMutex.unlock();
+	}
+
+	bool BufferManager::validatePage(const BufferFrame& frame, uint64_t version) const {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return frame.getVersion() == version;
+	}
+
+	bool BufferManager::lockPage(BufferFrame& frame, uint64_t version, bool exclusive) {
+		// Pages beyond the end of a mapped file cannot be written
+		if (exclusive && mapping != nullptr)
+			mapping->getFrame(frame.getId(), true);
+
+		frame.lock(exclusive);
+
+		// An exclusive lock has already incremented the version by one
+		if (frame.getVersion() == version + (exclusive ? 1 : 0))
+			return true;
 
 		frame.unlock();
+		return false;
+	}
+
+	void BufferManager::unfixPageOptimistic(BufferFrame& frame) {
+		unpinPage(&frame);
+	}
+
+	void BufferManager::flushAll() {
+		if (mapping != nullptr) {
+			dirtyPages -= mapping->sync(true, 0);
+			return;
+		}
+
+		std::vector<BufferFrame*> frames;
+		collectDirtyPages(frames, true, 0);
+		writePages(frames, true);
+	}
+
+	void BufferManager::flushSegment(uint16_t segment) {
+		if (mapping != nullptr) {
+			dirtyPages -= mapping->sync(false, segment);
+			return;
+		}
+
+		std::vector<BufferFrame*> frames;
+		collectDirtyPages(frames, false, segment);
+		writePages(frames, true);
+	}
+
+	FlushReport BufferManager::checkpoint() {
+		auto start = std::chrono::steady_clock::now();
+
+		if (mapping != nullptr) {
+			FlushReport report;
+			report.pages = mapping->sync(true, 0, &report.bytes);
+			report.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+			dirtyPages -= report.pages;
+			return report;
+		}
+
+		std::vector<BufferFrame*> frames;
+		collectDirtyPages(frames, true, 0);
+		std::sort(frames.begin(), frames.end(), comparePages);
+
+		// Find the frames of each segment
+		std::vector<std::pair<size_t, size_t>> segments;
+		for (size_t begin = 0, end = 0; begin < frames.size(); begin = end) {
+			uint16_t segment = frames[begin]->getId().segment();
+			while (end < frames.size() && frames[end]->getId().segment() == segment)
+				end++;
+
+			segments.push_back(std::make_pair(begin, end));
+		}
+
+		// Assign the largest segments first, each to the least loaded thread
+		std::sort(segments.begin(), segments.end(), [](const std::pair<size_t, size_t>& a, const std::pair<size_t, size_t>& b) {
+			return a.second - a.first > b.second - b.first;
+		});
+
+		std::vector<FlushTask> tasks(std::max(1u, std::min<unsigned>(flushThreads, segments.size())));
+		for (const std::pair<size_t, size_t>& segment : segments) {
+			FlushTask& task = *std::min_element(tasks.begin(), tasks.end(), [](const FlushTask& a, const FlushTask& b) {
+				return a.frames.size() < b.frames.size();
+			});
+
+			task.frames.insert(task.frames.end(), frames.begin() + segment.first, frames.begin() + segment.second);
+		}
+
+		// The calling thread writes the first partition itself
+		std::vector<pthread_t> threads(tasks.size());
+		for (size_t i = 0; i < tasks.size(); ++i) {
+			tasks[i].bm = this;
+			tasks[i].written = 0;
+			tasks[i].bytes = 0;
+
+			if (i > 0) {
+				int rc = pthread_create(&threads[i], nullptr, &runFlush, &tasks[i]);
+				assert(rc == 0);
+			}
+		}
+
+		runFlush(&tasks[0]);
+
+		FlushReport report;
+		for (size_t i = 0; i < tasks.size(); ++i) {
+			if (i > 0)
+				pthread_join(threads[i], nullptr);
+
+			report.pages += tasks[i].written;
+			report.bytes += tasks[i].bytes;
+		}
+
+		report.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		return report;
+	}
+
+	void BufferManager::awaitWarmup() {
+		warmupMutex.lock();
+		while (warming)
+			warmupCondition.wait(warmupMutex);
+		warmupMutex.unlock();
 	}
 
-	uint64_t BufferManager::hash(const PID& id) const {
-		// TODO: try out crc, murmur, fnv1a instead of identity
-		return id.page() & (slotCount - 1);
+	const char* BufferManager::getPolicyName() const {
+		return pools.front()->policy->getName();
+	}
+
+	BufferStats::Snapshot BufferManager::getStats() const {
+		return stats.snapshot();
+	}
+
+	void BufferManager::resetStats() {
+		stats.reset();
 	}
 
 	BufferManager::Slot& BufferManager::getSlot(const PID& id) const {
-		return pageTable[hash(id)];
+		return pageTable.getPartition(id);
 	}
 
-	BufferFrame* BufferManager::acquirePage(Slot& slot, const PID& id) {
-		BufferFrame* frame = slot.getFirst();
-		while (frame != nullptr && id != frame->getId())
-			frame = frame->tableNext;
+	BufferManager::FramePool* BufferManager::getPool(size_t pageSize) const {
+		for (FramePool* pool : pools) {
+			if (pool->arena.getPageSize() == pageSize)
+				return pool;
+		}
 
-		if (frame != nullptr)
-			registerPageAccess(frame);
+		return nullptr;
+	}
 
-		return frame;
+	BufferManager::FramePool& BufferManager::getPool(const BufferFrame* frame) const {
+		FramePool* pool = getPool(frame->getSize());
+		assert(pool != nullptr);
+		return *pool;
 	}
 
-	void BufferManager::registerPageAccess(BufferFrame* frame) {
-		if (frame->queue == QUEUE_AM) {
-			queueAm.bringFront(frame);
-		} else {
-			queueA1.remove(frame);
-			frame->queue = QUEUE_AM;
-			queueAm.prepend(frame);
+	ReplacementPolicy* BufferManager::createPolicy(const BufferOptions& options, uint64_t size) {
+		switch (options.replacement) {
+			case REPLACEMENT_CLOCK:
+				return new ClockPolicy();
+			case REPLACEMENT_LRU_K:
+				return new LruKPolicy();
+			case REPLACEMENT_ARC:
+				return new ArcPolicy(size);
+			default:
+				return new TwoQueuePolicy(size, options.queueThreshold);
 		}
 	}
 
-	BufferFrame* BufferManager::allocatePage(Slot& slot, const PID& id) {
-		BufferFrame* frame;
+	BufferFrame* BufferManager::findPage(Slot& slot, const PID& id) const {
+		return slot.find(id);
+	}
+
+	BufferFrame* BufferManager::requestPage(const PID& id, BufferRing* ring, uint64_t timeout, bool writable) {
+		if (mapping != nullptr)
+			return requestMappedPage(id, writable);
 
-		if (freePages > 0) {
-			frame = new BufferFrame(id);
-			freePages--;
-		} else {
-			BufferFrame* unused = findUnusedPage();
-			unused->save();
+		Slot& slot = getSlot(id);
+		if (trace != nullptr)
+			trace->record(id);
+
+		// Search for the frame
+		BufferFrame* frame = acquirePage(slot, id);
+		if (frame == nullptr) {
+			stats.count(COUNTER_MISSES);
+			detectSequentialAccess(id);
 
-			frame = new BufferFrame(id, std::move(*unused));
+			// Free the oldest frame of the ring first, so it can be reused
+			if (ring != nullptr)
+				recordPage(*ring, id);
 
-			unused->unlock();
-			delete unused;
+			return loadPage(slot, id, timeout);
 		}
 
-		frame->lock(true);
-		slot.prepend(frame);
+		stats.count(COUNTER_HITS);
+
+		// The first access to a page loaded by read ahead is not a reaccess.
+		// A marker page further continues read ahead with the next window.
+		ReadAheadState state = READ_AHEAD_NONE;
+		if (frame->readAhead != READ_AHEAD_NONE)
+			state = frame->readAhead.exchange(READ_AHEAD_NONE);
 
-		frame->queue = QUEUE_A1;
-		queueA1.prepend(frame);
+		if (state == READ_AHEAD_MARKER)
+			prefetch(PID(id.segment(), id.page() + readAheadPages), readAheadPages);
+
+		// Pages read ahead for a scan are recycled by its ring, too
+		if (state == READ_AHEAD_NONE)
+			getPool(frame).policy->access(frame);
+		else if (ring != nullptr)
+			recordPage(*ring, id);
 
 		return frame;
 	}
 
-	BufferFrame* BufferManager::findUnusedPage() {
-		BufferFrame* unused;
+	BufferFrame* BufferManager::requestMappedPage(const PID& id, bool writable) {
+		if (trace != nullptr)
+			trace->record(id);
+
+		BufferFrame* frame = mapping->getFrame(id, writable);
+		frame->fixCount++;
 
-		if (queueA1.getSize() > queueThreshold) {
-			unused = getLastUnusedPage(queueA1);
-			if (unused == nullptr)
-				unused = getLastUnusedPage(queueAm);
-		} else {
-			unused = getLastUnusedPage(queueAm);
-			if (unused == nullptr)
-				unused = getLastUnusedPage(queueA1);
+		FramePool& pool = getPool(frame);
+		if (frame->queue != QUEUE_NONE) {
+			stats.count(COUNTER_HITS);
+			pool.policy->access(frame);
+			return frame;
 		}
 
-		if (unused == nullptr) {
-			std::cerr << "ERROR: Out of memory." << std::endl;
-			exit(EXIT_CODE_NO_MORE_MEMORY);
+		// Another thread might have mapped the page in the meantime
+		mappingMutex.lock();
+		bool inserted = frame->queue == QUEUE_NONE;
+		if (inserted)
+			pool.policy->insert(frame);
+		mappingMutex.unlock();
+
+		stats.count(inserted ? COUNTER_MISSES : COUNTER_HITS);
+
+		// The buffer size is a soft limit, as all mapped pages might be fixed
+		if (inserted && ++mappedPages > frameCount)
+			pool.policy->evict(*this);
+
+		return frame;
+	}
+
+	void BufferManager::recordPage(BufferRing& ring, const PID& id) {
+		PID displaced(0);
+		if (ring.add(id, displaced))
+			discardPage(displaced);
+	}
+
+	void BufferManager::discardPage(const PID& id) {
+		Slot& slot = getSlot(id);
+
+		slot.lock(false);
+		BufferFrame* frame = findPage(slot, id);
+		slot.unlock();
+
+		if (frame == nullptr)
+			return;
+
+		// Frames are never deallocated, and the policy checks the page again
+		FramePool& pool = getPool(frame);
+		if (pool.policy->discard(frame, id, *this)) {
+			pool.freeFrames.prepend(frame, true);
+			wakeStalledThreads();
+		}
+	}
+
+	BufferFrame* BufferManager::loadPage(Slot& slot, const PID& id, uint64_t timeout) {
+		// Create a new frame without holding the slot, as this might page out
+		// frames from other slots.
+		BufferFrame* frame = allocatePage(id, timeout);
+		if (frame == nullptr)
+			return nullptr;
+
+		// Another thread might have loaded the page in the meantime
+		slot.lock(true);
+		BufferFrame* existing = findPage(slot, id);
+		if (existing != nullptr) {
+			existing->fixCount++;
+			slot.unlock();
+
+			releasePage(frame);
+			getPool(existing).policy->access(existing);
+			return existing;
 		}
 
-		return unused;
+		slot.insert(frame);
+		slot.unlock();
+
+		getPool(frame).policy->insert(frame);
+
+		// Other threads wait for the exclusive lock until the data is loaded
+		uint64_t start = BufferStats::now();
+		frame->load();
+		stats.record(LATENCY_LOAD, BufferStats::now() - start);
+		frame->unlock();
+
+		return frame;
+	}
+
+	BufferFrame* BufferManager::acquirePage(Slot& slot, const PID& id) {
+		slot.lock(false);
+
+		BufferFrame* frame = findPage(slot, id);
+		if (frame != nullptr)
+			frame->fixCount++;
+
+		slot.unlock();
+		return frame;
 	}
 
-	BufferFrame* BufferManager::getLastUnusedPage(Queue& queue) {
-		BufferFrame* frame = queue.getLast();
-		while (frame != nullptr && !frame->tryLock(true))
-			frame = frame->queuePrev;
+	BufferFrame* BufferManager::allocatePage(const PID& id, uint64_t timeout) {
+		FramePool* pool = getPool(files.getPageSize(id.segment()));
+		assert(pool != nullptr);
 
+		BufferFrame* frame = findUnusedPage(*pool);
+		if (frame == nullptr && timeout > 0)
+			frame = waitForUnusedPage(*pool, timeout);
 		if (frame == nullptr)
 			return nullptr;
 
-		getSlot(frame->getId()).remove(frame);
-		queue.remove(frame);
+		frame->reset(id, files.get(id.segment()));
+		frame->fixCount = 1;
+		frame->lock(true);
+		return frame;
+	}
+
+	void BufferManager::releasePage(BufferFrame* frame) {
+		frame->fixCount = 0;
+		frame->unlock();
+		getPool(frame).freeFrames.prepend(frame, true);
+		wakeStalledThreads();
+	}
+
+	void BufferManager::unpinPage(BufferFrame* frame) {
+		if (--frame->fixCount == 0)
+			wakeStalledThreads();
+	}
+
+	void BufferManager::lockFrame(BufferFrame* frame, bool exclusive, bool update) {
+		// Only measure contended latches to keep the hit path cheap
+		if (update ? frame->tryLockUpdate() : frame->tryLock(exclusive))
+			return;
+
+		uint64_t start = BufferStats::now();
+		if (update)
+			frame->lockUpdate();
+		else
+			frame->lock(exclusive);
+		stats.record(LATENCY_LOCK_WAIT, BufferStats::now() - start);
+	}
+
+	BufferFrame* BufferManager::findUnusedPage(FramePool& pool) {
+		pool.freeFrames.lock(true);
+		BufferFrame* frame = pool.freeFrames.getFirst();
+		if (frame != nullptr)
+			pool.freeFrames.remove(frame);
+		pool.freeFrames.unlock();
+
+		if (frame == nullptr)
+			frame = pool.policy->evict(*this);
+
+		// Victims are never written while the policy is latched. If all
+		// unfixed frames are dirty, clean the coldest ones and try again.
+		if (frame == nullptr && dirtyPages > 0) {
+			std::vector<BufferFrame*> frames;
+			pool.policy->collectDirty(frames, std::max<uint64_t>(pool.cleanTarget, BUFFER_FLUSH_RUN), BUFFER_FLUSH_RUN);
+			if (writePages(frames, false) > 0)
+				frame = pool.policy->evict(*this);
+		}
+
 		return frame;
 	}
 
+	BufferFrame* BufferManager::waitForUnusedPage(FramePool& pool, uint64_t timeout) {
+		auto start = std::chrono::steady_clock::now();
+		uint64_t waited = 0;
+
+		stalledThreads++;
+
+		// Wake ups might be missed between two attempts, so never wait long
+		BufferFrame* frame = nullptr;
+		while (frame == nullptr && waited < timeout) {
+			stallMutex.lock();
+			stallCondition.wait(stallMutex, std::min<uint64_t>(timeout - waited, BUFFER_STALL_INTERVAL));
+			stallMutex.unlock();
+
+			frame = findUnusedPage(pool);
+			waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		stalledThreads--;
+		stats.record(LATENCY_STALL, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+		return frame;
+	}
+
+	void BufferManager::wakeStalledThreads() {
+		if (stalledThreads == 0)
+			return;
+
+		stallMutex.lock();
+		stallCondition.broadcast();
+		stallMutex.unlock();
+	}
+
+	bool BufferManager::evictFrame(BufferFrame* frame) {
+		// Unmapping does not lose data, even if the page is fixed again
+		// concurrently: the next access maps it from the page cache.
+		if (mapping != nullptr) {
+			if (frame->fixCount > 0)
+				return false;
+
+			mapping->release(frame);
+			mappedPages--;
+			stats.count(COUNTER_EVICTIONS);
+			return true;
+		}
+
+		// Once the slot is latched, no other thread can find the frame.
+		Slot& slot = getSlot(frame->getId());
+		slot.lock(true);
+
+		// Dirty frames stay in the page table until they have been written
+		// by findUnusedPage or the writer, so a failed write loses no data.
+		// Unfixed frames cannot become dirty while the slot is latched.
+		if (frame->fixCount > 0 || frame->isDirty()) {
+			slot.unlock();
+			return false;
+		}
+
+		slot.remove(frame);
+		stats.count(COUNTER_EVICTIONS);
+
+		slot.unlock();
+		return true;
+	}
+
+	void* BufferManager::runWriter(void* arg) {
+		BufferManager* bm = static_cast<BufferManager*>(arg);
+		auto manifestTime = std::chrono::steady_clock::now();
+
+		bm->writerMutex.lock();
+		while (!bm->stopping) {
+			bm->writerMutex.unlock();
+
+			if (bm->dirtyPages > 0)
+				bm->flushColdPages(bm->flushBatch);
+
+			// Save the manifest periodically, so it survives a crash
+			auto now = std::chrono::steady_clock::now();
+			if (bm->manifestInterval > 0 && !bm->manifestFile.empty()
+			    && uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(now - manifestTime).count()) >= bm->manifestInterval) {
+				bm->saveManifest();
+				manifestTime = now;
+			}
+
+			bm->writerMutex.lock();
+			if (!bm->stopping)
+				bm->writerCondition.wait(bm->writerMutex, BUFFER_WRITER_INTERVAL);
+		}
+		bm->writerMutex.unlock();
+
+		return nullptr;
+	}
+
+	void BufferManager::flushColdPages(uint64_t budget) {
+		std::vector<BufferFrame*> frames;
+		for (FramePool* pool : pools) {
+			if (frames.size() < budget)
+				pool->policy->collectDirty(frames, pool->cleanTarget, budget - frames.size());
+		}
+
+		stats.count(COUNTER_BACKGROUND_WRITES, writePages(frames, false));
+	}
+
+	uint64_t BufferManager::writePages(std::vector<BufferFrame*>& frames, bool wait, uint64_t* bytes) {
+		std::sort(frames.begin(), frames.end(), comparePages);
+
+		std::vector<BufferFrame*> run;
+		uint64_t written = 0;
+
+		for (BufferFrame* frame : frames) {
+			PID id = frame->getId();
+			bool locked = false;
+
+			// Extend the current run without waiting, as other latches are held
+			if (!run.empty() && run.size() < BUFFER_FLUSH_RUN) {
+				PID last = run.back()->getId();
+				if (id.segment() == last.segment() && id.page() == last.page() + 1)
+					locked = frame->tryLock(false);
+			}
+
+			if (!locked) {
+				written += writeRun(run, bytes);
+				locked = wait ? frame->lock(false) : frame->tryLock(false);
+			}
+
+			if (locked && frame->isDirty()) {
+				run.push_back(frame);
+				continue;
+			}
+
+			if (locked)
+				frame->unlock();
+			unpinPage(frame);
+		}
+
+		written += writeRun(run, bytes);
+		return written;
+	}
+
+	uint64_t BufferManager::writeRun(std::vector<BufferFrame*>& run, uint64_t* bytes) {
+		if (run.empty())
+			return 0;
+
+		std::vector<const void*> buffers;
+		for (BufferFrame* frame : run)
+			buffers.push_back(frame->getData());
+
+		// All pages of a segment have the same size
+		PID first = run.front()->getId();
+		size_t pageSize = run.front()->getSize();
+		File<void>& file = files.get(first.segment());
+
+		uint64_t start = BufferStats::now();
+		bool success = file.writeGather(buffers.data(), int(run.size()), pageSize, off_t(first.page()) * pageSize);
+		stats.record(LATENCY_SAVE, BufferStats::now() - start);
+
+		uint64_t written = 0;
+		for (BufferFrame* frame : run) {
+			if (success && frame->setClean()) {
+				dirtyPages--;
+				written++;
+
+				if (bytes != nullptr)
+					*bytes += pageSize;
+			}
+
+			frame->unlock();
+			unpinPage(frame);
+		}
+
+		stats.count(COUNTER_WRITES, written);
+		run.clear();
+		return written;
+	}
+
+	void BufferManager::collectDirtyPages(std::vector<BufferFrame*>& frames, bool all, uint16_t segment) {
+		for (uint64_t i = 0; i < pageTable.getPartitionCount(); ++i) {
+			Slot& slot = pageTable.getPartitionAt(i);
+			slot.lock(false);
+
+			for (uint64_t j = 0; j < slot.getCapacity(); ++j) {
+				BufferFrame* frame = slot.getFrame(j);
+				if (frame != nullptr && frame->isDirty() && (all || frame->getId().segment() == segment)) {
+					frame->fixCount++;
+					frames.push_back(frame);
+				}
+			}
+
+			slot.unlock();
+		}
+	}
+
+	bool BufferManager::hasResidentPages(uint16_t segment) {
+		if (mapping != nullptr)
+			return mapping->isMapped(segment);
+
+		bool resident = false;
+		for (uint64_t i = 0; !resident && i < pageTable.getPartitionCount(); ++i) {
+			Slot& slot = pageTable.getPartitionAt(i);
+			slot.lock(false);
+
+			for (uint64_t j = 0; !resident && j < slot.getCapacity(); ++j) {
+				BufferFrame* frame = slot.getFrame(j);
+				resident = frame != nullptr && frame->getId().segment() == segment;
+			}
+
+			slot.unlock();
+		}
+
+		return resident;
+	}
+
+	void* BufferManager::runFlush(void* arg) {
+		FlushTask* task = static_cast<FlushTask*>(arg);
+		task->written = task->bm->writePages(task->frames, true, &task->bytes);
+		return nullptr;
+	}
+
+	bool BufferManager::saveManifest() {
+		std::vector<PageManifest::Entry> pages;
+		std::vector<PID> ids;
+
+		for (FramePool* pool : pools) {
+			ids.clear();
+			pool->policy->collectPages(ids);
+			for (const PID& id : ids)
+				pages.push_back(PageManifest::Entry{ id, pool->arena.getPageSize() });
+		}
+
+		return PageManifest::save(manifestFile, pages);
+	}
+
+	void BufferManager::warmUp() {
+		std::sort(warmupPages.begin(), warmupPages.end(), [](const PageManifest::Entry& a, const PageManifest::Entry& b) {
+			return a.id.segment() < b.id.segment() || (a.id.segment() == b.id.segment() && a.id.page() < b.id.page());
+		});
+
+		uint16_t segment = 0;
+		off_t pageCount = -1;
+
+		for (const PageManifest::Entry& entry : warmupPages) {
+			if (stopping)
+				break;
+
+			const PID& id = entry.id;
+
+			// Skip pages of segments which have been truncated in between, or
+			// which have been fixed with another page size already
+			if (pageCount < 0 || id.segment() != segment) {
+				segment = id.segment();
+				pageCount = setPageSize(segment, entry.pageSize) ? files.get(segment).size() / entry.pageSize : 0;
+			}
+
+			if (id.page() >= pageCount)
+				continue;
+
+			Slot& slot = getSlot(id);
+			BufferFrame* frame = acquirePage(slot, id);
+			if (frame == nullptr) {
+				// Stop if all frames are in use
+				frame = loadPage(slot, id, 0);
+				if (frame == nullptr)
+					break;
+
+				stats.count(COUNTER_WARMUP);
+			}
+
+			unpinPage(frame);
+		}
+
+		warmupPages.clear();
+		warmupPages.shrink_to_fit();
+	}
+
+	void* BufferManager::runWarmup(void* arg) {
+		BufferManager* bm = static_cast<BufferManager*>(arg);
+		bm->warmUp();
+
+		bm->warmupMutex.lock();
+		bm->warming = false;
+		bm->warmupCondition.broadcast();
+		bm->warmupMutex.unlock();
+
+		return nullptr;
+	}
+
+	void BufferManager::detectSequentialAccess(const PID& id) {
+		if (readAheadPages == 0)
+			return;
+
+		SequentialAccess& access = sequentialAccess[id.segment() % BUFFER_READ_AHEAD_SEGMENTS];
+
+		// Concurrent scans of segments sharing an entry only disturb detection
+		uint64_t expected = access.next.exchange(PID(id.segment(), id.page() + 1).id);
+		if (expected != id.id) {
+			access.run = 0;
+			return;
+		}
+
+		// Start read ahead, and restart it if the scan has overtaken it
+		uint32_t run = ++access.run;
+		if (run >= BUFFER_READ_AHEAD_TRIGGER && (run - BUFFER_READ_AHEAD_TRIGGER) % readAheadPages == 0)
+			prefetch(PID(id.segment(), id.page() + 1), readAheadPages);
+	}
+
+	void* BufferManager::runReadAhead(void* arg) {
+		BufferManager* bm = static_cast<BufferManager*>(arg);
+
+		bm->readAheadMutex.lock();
+		while (true) {
+			while (!bm->stopping && bm->readAheadRequests.empty())
+				bm->readAheadCondition.wait(bm->readAheadMutex);
+
+			if (bm->stopping)
+				break;
+
+			std::pair<PID, uint32_t> request = bm->readAheadRequests.front();
+			bm->readAheadRequests.pop_front();
+			bm->readAheadMutex.unlock();
+
+			bm->readAhead(request.first, request.second);
+			bm->readAheadMutex.lock();
+		}
+		bm->readAheadMutex.unlock();
+
+		return nullptr;
+	}
+
+	void BufferManager::readAhead(const PID& first, uint32_t count) {
+		// Do not create frames for pages which have never been written
+		off_t pageCount = files.get(first.segment()).size() / files.getPageSize(first.segment());
+
+		for (uint32_t i = 0; i < count && first.page() + i < pageCount; ++i) {
+			PID id(first.segment(), first.page() + i);
+			Slot& slot = getSlot(id);
+
+			BufferFrame* frame = acquirePage(slot, id);
+			if (frame == nullptr) {
+				// Stop if all frames are in use
+				frame = loadPage(slot, id, 0);
+				if (frame == nullptr)
+					break;
+
+				frame->readAhead = READ_AHEAD_PAGE;
+				stats.count(COUNTER_READ_AHEAD);
+			}
+
+			// Reaching the first page of this window triggers the next one
+			if (i == 0)
+				frame->readAhead = READ_AHEAD_MARKER;
+
+			unpinPage(frame);
+		}
+	}
+
 }
\ No newline at end of file
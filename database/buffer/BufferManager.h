@@ -9,57 +9,331 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+#include <pthread.h>
 
 #include "utils/ConcurrentList.h"
+#include "utils/Condition.h"
 #include "utils/Mutex.h"
+#include "AccessTrace.h"
 #include "BufferFrame.h"
+#include "BufferRing.h"
+#include "BufferStats.h"
+#include "FrameArena.h"
+#include "PageManifest.h"
+#include "PageMapping.h"
+#include "PageTable.h"
+#include "ReplacementPolicy.h"
+#include "SegmentFiles.h"
 
 #define BUFFER_MANAGER_QUEUE_THRESHOLD 0.5
-#define EXIT_CODE_NO_MORE_MEMORY 42
+
+#define BUFFER_WAIT_FOREVER UINT64_MAX
+#define BUFFER_STALL_INTERVAL 1000
+
+#define BUFFER_WRITER_INTERVAL 10000
+#define BUFFER_WRITER_FLUSH_RATE 10000
+#define BUFFER_WRITER_CLEAN_RATIO 0.1
+
+#define BUFFER_READ_AHEAD_PAGES 32
+#define BUFFER_READ_AHEAD_THREADS 2
+#define BUFFER_READ_AHEAD_TRIGGER 4
+#define BUFFER_READ_AHEAD_QUEUE 16
+#define BUFFER_READ_AHEAD_SEGMENTS 64
+
+#define BUFFER_FLUSH_RUN 64
+#define BUFFER_FLUSH_THREADS 4
 
 namespace lsql {
 
+	/**
+	 * Configuration of an additional frame pool of a @c BufferManager.
+	 */
+	struct PoolOptions {
+
+		/**
+		 * The size of pages in this pool in bytes. This must be a multiple of
+		 * the page size of the operating system.
+		 */
+		size_t pageSize;
+
+		/**
+		 * The number of frames in this pool.
+		 */
+		uint64_t frames;
+
+	};
+
+	/**
+	 * Configuration of a @c BufferManager. The defaults suit most workloads.
+	 */
+	struct BufferOptions {
+
+		/**
+		 * The maximum number of pages per second written by the background
+		 * writer. Setting this to zero disables the background writer.
+		 */
+		uint64_t flushRate = BUFFER_WRITER_FLUSH_RATE;
+
+		/**
+		 * The fraction of frames at the cold end of each replacement queue,
+		 * which the background writer tries to keep clean.
+		 */
+		double cleanRatio = BUFFER_WRITER_CLEAN_RATIO;
+
+		/**
+		 * The number of pages loaded at once when reading ahead. Setting this
+		 * to zero disables read ahead.
+		 */
+		uint32_t readAheadPages = BUFFER_READ_AHEAD_PAGES;
+
+		/**
+		 * The number of I/O threads loading pages for read ahead.
+		 */
+		unsigned readAheadThreads = BUFFER_READ_AHEAD_THREADS;
+
+		/**
+		 * Whether to back the frame pool with huge pages, if the platform
+		 * supports it. See @c FrameArena.
+		 */
+		bool hugePages = true;
+
+		/**
+		 * Whether to read and write pages with direct I/O. This bypasses the
+		 * page cache of the operating system, so that pages are not cached
+		 * twice. See @c File::open.
+		 */
+		bool directIO = false;
+
+		/**
+		 * Whether to map the segment files into memory instead of loading
+		 * pages into frames. See @c PageMapping. In mapped mode, the
+		 * operating system reads and writes pages, and the buffer size only
+		 * limits the number of pages kept mapped. There is no background
+		 * writer, read ahead is delegated to the operating system, and the
+		 * buffer is not warmed up from a manifest.
+		 */
+		bool mapped = false;
+
+		/**
+		 * The maximum number of pages per segment in mapped mode. This much
+		 * virtual memory is reserved for every segment accessed.
+		 */
+		uint64_t mappedPages = PAGE_MAPPING_PAGES;
+
+		/**
+		 * The page replacement algorithm. See @c ReplacementPolicy.
+		 */
+		ReplacementType replacement = REPLACEMENT_2Q;
+
+		/**
+		 * The share of frames in queue A1 of the 2Q policy, above which
+		 * frames are paged out from A1 instead of Am.
+		 */
+		double queueThreshold = BUFFER_MANAGER_QUEUE_THRESHOLD;
+
+		/**
+		 * If not empty, all page requests are recorded into a trace file at
+		 * this path. See @c AccessTrace.
+		 */
+		std::string traceFile;
+
+		/**
+		 * The maximum time in microseconds @c fixPage waits for a frame to
+		 * become available, if all frames are fixed. Afterwards, it throws a
+		 * @c BufferStallError.
+		 */
+		uint64_t stallTimeout = BUFFER_WAIT_FOREVER;
+
+		/**
+		 * The number of threads writing dirty frames in @c checkpoint and on
+		 * shutdown. Each segment file is written by a single thread.
+		 */
+		unsigned flushThreads = BUFFER_FLUSH_THREADS;
+
+		/**
+		 * Whether to print the bytes written and the elapsed time when the
+		 * buffer manager flushes its frames on shutdown.
+		 */
+		bool reportFlush = false;
+
+		/**
+		 * If not empty, the pages in the buffer are saved to a manifest at
+		 * this path on shutdown. When a buffer manager is created, the pages
+		 * listed in the manifest are loaded in the background. See
+		 * @c PageManifest.
+		 */
+		std::string manifestFile;
+
+		/**
+		 * The interval in microseconds in which the background writer also
+		 * saves the manifest. Setting this to zero, or disabling the
+		 * background writer, only saves it on shutdown.
+		 */
+		uint64_t manifestInterval = 0;
+
+		/**
+		 * Frame pools for segments with pages of other sizes than
+		 * @c BufferFrame::SIZE. Each page size needs its own pool, see
+		 * @c BufferManager::setPageSize.
+		 */
+		std::vector<PoolOptions> pools;
+
+	};
+
+	/**
+	 * The result of writing dirty frames to disc.
+	 */
+	struct FlushReport {
+
+		/** The number of pages written. */
+		uint64_t pages = 0;
+
+		/** The number of bytes written. */
+		uint64_t bytes = 0;
+
+		/** The elapsed time in microseconds. */
+		uint64_t time = 0;
+
+	};
+
+	/**
+	 * Thrown by the fix methods of the @c BufferManager if no frame became
+	 * available within the stall timeout. No frame is fixed in that case,
+	 * so the caller may release its own frames and retry.
+	 */
+	class BufferStallError : public std::exception {
+	public:
+		const char* what() const throw() {
+			return "no buffer frame became available within the stall timeout";
+		}
+	};
+
 	/**
 	 * Manages buffer frames and controls concurrent access to these frames.
 	 * Frames are loaded from and stored into a file on the disc. For more
 	 * information about frames, see @c BufferFrame.
+	 *
+	 * There is no global lock in the buffer manager. Each slot of the page
+	 * table is a small open addressing table latched on its own, so fixing
+	 * pages that hash into different slots never contends. While a frame is
+	 * fixed, its @c fixCount prevents it from being paged out. Latches are
+	 * always acquired in the order replacement policy, slot, frame -- no
+	 * thread holds a slot latch while waiting for a policy or frame latch.
+	 *
+	 * Which frames are paged out is decided by a @c ReplacementPolicy, which
+	 * is selected in the @c BufferOptions. By default, this is 2Q.
+	 *
+	 * Dirty frames are written to disc by a background writer, which keeps
+	 * the frames at the cold end of both queues clean. Thus, paging out a
+	 * frame usually does not have to wait for a write.
+	 *
+	 * When pages of a segment are missed in sequential order, or a caller
+	 * hints at an upcoming scan via @c prefetch, the following pages are
+	 * loaded in the background by a pool of I/O threads.
+	 *
+	 * All frames are preallocated in a @c FrameArena when the buffer manager
+	 * is created. Paging out a frame only reassigns it to another page, so
+	 * the miss path does not allocate any memory.
+	 *
+	 * Segments may use different page sizes. Frames of each page size form
+	 * a separate pool with its own free frames and replacement policy, so a
+	 * page is only ever replaced by a page of the same size and memory does
+	 * not fragment. The default pool holds pages of @c BufferFrame::SIZE
+	 * bytes; further pools are configured in the @c BufferOptions.
+	 *
+	 * If a manifest file is configured, the pages in the buffer are listed in
+	 * it on shutdown and loaded again in the background on the next start, so
+	 * that the buffer is warm before traffic is admitted.
+	 *
+	 * For read-heavy workloads, the buffer manager can run in mapped mode
+	 * instead, selected in the @c BufferOptions. Pages are then accessed
+	 * through memory mappings of the segment files, so a fix only computes
+	 * the address of the frame, and the operating system performs all I/O.
+	 * The contract of all methods is the same in both modes.
 	 */
-	class BufferManager {
+	class BufferManager : private FrameEvictor {
 
 		/**
-		 * Implementation of the ConcurrentList AccessPolicy for Queues.
+		 * Type definition for latched slots of the page table.
 		 */
-		struct QueuePolicy {
-			BufferFrame*& next(BufferFrame* frame) const { return frame->queueNext; }
-			BufferFrame*& prev(BufferFrame* frame) const { return frame->queuePrev; }
-		};
+		typedef PageTable::Partition Slot;
 
 		/**
-		 * Implementation of the ConcurrentList AccessPolicy for the page table.
+		 * Frames of one page size and the policy deciding which of them are
+		 * paged out.
 		 */
-		struct TablePolicy {
-			BufferFrame*& next(BufferFrame* frame) const { return frame->tableNext; }
-			BufferFrame*& prev(BufferFrame* frame) const { return frame->tablePrev; }
+		struct FramePool {
+			FrameArena arena;
+			FrameQueue freeFrames;
+			ReplacementPolicy* policy;
+			uint64_t cleanTarget;
+			FramePool(uint64_t count, bool hugePages, size_t pageSize)
+			: arena(count, hugePages, pageSize), policy(nullptr), cleanTarget(0) {}
 		};
-		
+
 		/**
-		 * Type definition for threadsafe queues of buffer frames.
+		 * Dirty frames of one or more segments written by a flush thread.
 		 */
-		typedef ConcurrentList<BufferFrame, QueuePolicy> Queue;
+		struct FlushTask {
+			BufferManager* bm;
+			std::vector<BufferFrame*> frames;
+			uint64_t written;
+			uint64_t bytes;
+		};
 
 		/**
-		 * Type definition for threadsafe lists of buffer frames in page tables.
+		 * Detection state for sequential page misses in a segment.
 		 */
-		typedef ConcurrentList<BufferFrame, TablePolicy> Slot;
+		struct SequentialAccess {
+			std::atomic<uint64_t> next;
+			std::atomic<uint32_t> run;
+			SequentialAccess() : next(0), run(0) {}
+		};
+
+		std::atomic<uint64_t> dirtyPages;
+		BufferStats stats;
 
-		Mutex mutex;
-		uint64_t freePages;
-		uint64_t queueThreshold;
-		uint64_t slotCount;
+		std::atomic<uint32_t> stalledThreads;
+		uint64_t stallTimeout;
+		Mutex stallMutex;
+		Condition stallCondition;
 
-		Slot* pageTable;
-		Queue queueA1;
-		Queue queueAm;
+		uint64_t flushBatch;
+		unsigned flushThreads;
+		bool reportFlush;
+
+		std::string manifestFile;
+		uint64_t manifestInterval;
+		std::vector<PageManifest::Entry> warmupPages;
+		bool warming;
+		Mutex warmupMutex;
+		Condition warmupCondition;
+		uint32_t readAheadPages;
+
+		std::atomic<bool> stopping;
+		std::vector<pthread_t> workers;
+		Mutex writerMutex;
+		Condition writerCondition;
+		Mutex readAheadMutex;
+		Condition readAheadCondition;
+		std::deque<std::pair<PID, uint32_t>> readAheadRequests;
+		SequentialAccess sequentialAccess[BUFFER_READ_AHEAD_SEGMENTS];
+
+		SegmentFiles files;
+		PageTable pageTable;
+		PageMapping* mapping;
+		std::atomic<uint64_t> mappedPages;
+		Mutex mappingMutex;
+		AccessTrace* trace;
+
+		std::vector<FramePool*> pools;
+		uint64_t frameCount;
 
 	public:
 
@@ -67,32 +341,101 @@ namespace lsql {
 		 * Creates a new buffer manager instance which operates on the
 		 * specified file.
 		 *
-		 * @param size The maximum number of frames in memory.
+		 * @param size    The number of frames of @c BufferFrame::SIZE bytes.
+		 * @param options Additional configuration, see @c BufferOptions.
 		 */
-		BufferManager(uint64_t size);
+		BufferManager(uint64_t size, const BufferOptions& options = BufferOptions());
 
 		/**
-		 * Destroys this buffer manager instance and writes all dirty
-		 * frames to disc.
+		 * Destroys this buffer manager instance, stops the background writer
+		 * and writes all dirty frames to disc.
 		 */
 		~BufferManager();
 
+		/**
+		 * Sets the size of all pages in a segment. This must happen before any
+		 * page of the segment is fixed, and there must be a frame pool for
+		 * the page size. The catalog sets the page size of each relation.
+		 * Pages loaded while warming up already carry the size stored in the
+		 * manifest.
+		 *
+		 * @param segment  The identifier of the segment.
+		 * @param pageSize The page size in bytes.
+		 *
+		 * @return True if the page size is supported; false if there is no
+		 *         pool for it, or if the segment has pages of a different
+		 *         size in memory.
+		 */
+		bool setPageSize(uint16_t segment, size_t pageSize);
+
+		/**
+		 * Returns the size of all pages in a segment. Unless set otherwise,
+		 * this is @c BufferFrame::SIZE.
+		 *
+		 * @param segment The identifier of the segment.
+		 * @return The page size in bytes.
+		 */
+		size_t getPageSize(uint16_t segment);
+
 		/**
 		 * Retrieves the specified frame. If the frame is not in memory,
 		 * it will be loaded from disc. This might force old unfixed
 		 * frames to get flushed to disc and removed from memory.
 		 *
-		 * If there is no space left for new frames, this method might
-		 * fail to return a frame and will exit with an error message.
+		 * If all frames are fixed, this method waits until another thread
+		 * releases a frame. If none is released within the stall timeout of
+		 * the @c BufferOptions, it throws a @c BufferStallError.
+		 *
+		 * For bulk sequential reads, a @c BufferRing can be passed as access
+		 * strategy. Pages loaded through the ring are paged out again once
+		 * they drop out of the ring, unless they are accessed by someone else.
 		 *
 		 * @param id        An identifier for the page to load.
 		 * @param exclusive Whether or not this frame is exclusive to the
 		 *                  caller of this method.
+		 * @param ring      An optional ring to recycle frames for scans.
 		 *
 		 * @return A reference to the buffer frame. See @c BufferFrame
 		 *         for more details.
+		 *
+		 * @throws BufferStallError If the stall timeout expires.
 		 */
-		BufferFrame& fixPage(const PID& id, bool exclusive);
+		BufferFrame& fixPage(const PID& id, bool exclusive, BufferRing* ring = nullptr);
+
+		/**
+		 * Retrieves the specified frame like @c fixPage, but fails if no frame
+		 * becomes available within the given time. This allows callers to
+		 * reject requests under peak load.
+		 *
+		 * @param id        An identifier for the page to load.
+		 * @param exclusive Whether or not this frame is exclusive to the
+		 *                  caller of this method.
+		 * @param timeout   The maximum time to wait in microseconds.
+		 *
+		 * @return A pointer to the buffer frame, or @c nullptr.
+		 */
+		BufferFrame* tryFixPage(const PID& id, bool exclusive, uint64_t timeout);
+
+		/**
+		 * Retrieves the specified frame like @c fixPage, but locks it in
+		 * update mode. Other threads can still fix the page shared, but not
+		 * for update or exclusively. Use @c upgradePage before modifying it.
+		 *
+		 * @param id An identifier for the page to load.
+		 * @return A reference to the buffer frame.
+		 *
+		 * @throws BufferStallError If the stall timeout expires.
+		 */
+		BufferFrame& fixPageUpdate(const PID& id);
+
+		/**
+		 * Converts the update lock on a frame retrieved by @c fixPageUpdate
+		 * into an exclusive lock. This waits until all shared locks on the
+		 * frame have been released. The frame does not change in between.
+		 *
+		 * @param frame The frame fixed for update by the caller.
+		 */
+		void upgradePage(BufferFrame& frame);
 
 		/**
 		 * Releases the given frame. Thus, the frame can be paged out,
@@ -101,23 +444,135 @@ namespace lsql {
 		 */
 		void unfixPage(BufferFrame& frame, bool isDirty);
 
-	private:
+		/**
+		 * Fixes a frame once more in shared mode, which the caller already
+		 * holds in shared mode. As the frame cannot be paged out meanwhile,
+		 * this does not look up the page table. Each call must be matched by
+		 * a call to @c unfixPage.
+		 *
+		 * @param frame The frame fixed in shared mode by the caller.
+		 */
+		void refixPage(BufferFrame& frame);
 
 		/**
-		 * Creates a hash value for the specified page using an internal
-		 * hashing algorithm.
+		 * Hints that the given pages will be accessed soon. The pages are
+		 * loaded asynchronously into frames which are not in use, so this
+		 * method returns immediately. Pages which do not exist on disc yet are
+		 * skipped.
 		 *
-		 * The hash is guaranteed not to exceed @c slotCount, if slotCount is
-		 * a power of two. Otherwise, the hashed value is undefined.
+		 * @param first The first page to load.
+		 * @param count The number of consecutive pages to load.
+		 */
+		void prefetch(const PID& first, uint32_t count);
+
+		/**
+		 * Retrieves the specified frame for optimistic reading. Just like
+		 * @c fixPage, the frame is loaded if necessary and fixed in memory,
+		 * but it is not locked.
 		 *
-		 * @param id The page identifier to obtain the hash value from.
-		 * @return The hashed value of @c id.
+		 * Instead, the current version of the frame is returned. Data read from
+		 * the frame is only valid, if a subsequent call to @c validatePage with
+		 * this version succeeds. Otherwise, the read has to be retried. If the
+		 * frame is currently locked exclusively, this method waits until the
+		 * lock is released.
+		 *
+		 * @param id      An identifier for the page to load.
+		 * @param version Receives the version of the frame.
+		 *
+		 * @return A reference to the buffer frame.
+		 *
+		 * @throws BufferStallError If the stall timeout expires.
+		 */
+		BufferFrame& fixPageOptimistic(const PID& id, uint64_t& version);
+
+		/**
+		 * Checks whether the frame has been locked exclusively since the given
+		 * version was obtained by @c fixPageOptimistic.
+		 *
+		 * @param frame   A frame fixed by @c fixPageOptimistic.
+		 * @param version The version returned by @c fixPageOptimistic.
+		 *
+		 * @return True if all data read since then is valid; otherwise false.
+		 */
+		bool validatePage(const BufferFrame& frame, uint64_t version) const;
+
+		/**
+		 * Locks a frame retrieved by @c fixPageOptimistic, if it has not been
+		 * modified since the given version was obtained. On success, the frame
+		 * has to be released with @c unfixPage; otherwise it remains fixed
+		 * optimistically.
+		 *
+		 * @param frame     A frame fixed by @c fixPageOptimistic.
+		 * @param version   The version returned by @c fixPageOptimistic.
+		 * @param exclusive Whether or not the lock should be exclusive.
+		 *
+		 * @return True if the frame has been locked; otherwise false.
 		 */
-		uint64_t hash(const PID& id) const;
+		bool lockPage(BufferFrame& frame, uint64_t version, bool exclusive);
+
+		/**
+		 * Releases a frame retrieved by @c fixPageOptimistic. The frame must
+		 * not be locked by the caller.
+		 */
+		void unfixPageOptimistic(BufferFrame& frame);
+
+		/**
+		 * Writes all dirty frames to disc. Frames are written in the order of
+		 * their pages, and runs of adjacent pages are written with a single
+		 * system call.
+		 *
+		 * The caller must not hold a lock on any frame, but other threads may
+		 * continue to fix and modify pages. Pages modified concurrently might
+		 * be dirty again when this method returns.
+		 */
+		void flushAll();
+
+		/**
+		 * Writes all dirty frames of a segment to disc. See @c flushAll.
+		 *
+		 * @param segment The identifier of the segment.
+		 */
+		void flushSegment(uint16_t segment);
+
+		/**
+		 * Writes all dirty frames to disc like @c flushAll, but spreads the
+		 * segment files over the number of threads given in the
+		 * @c BufferOptions. This is also done when destroying the buffer
+		 * manager.
+		 *
+		 * @return The amount of data written and the time it took.
+		 */
+		FlushReport checkpoint();
+
+		/**
+		 * Waits until all pages listed in the manifest have been loaded after
+		 * creating the buffer manager. Returns immediately, if there is no
+		 * manifest.
+		 */
+		void awaitWarmup();
+
+		/**
+		 * Returns the name of the page replacement policy in use.
+		 */
+		const char* getPolicyName() const;
+
+		/**
+		 * Returns a copy of the statistics collected since construction or
+		 * the last call to @c resetStats. Pages loaded by read ahead count as
+		 * hits when they are requested.
+		 */
+		BufferStats::Snapshot getStats() const;
+
+		/**
+		 * Resets all statistics to zero.
+		 */
+		void resetStats();
+
+	private:
 
 		/**
 		 * Returns a reference to the appropriate slot in the page table
-		 * determined by the internal hash function.
+		 * determined by the hash of the full page id. See @c PageTable.
 		 *
 		 * @param id The page identifier to obtain the hash value from.
 		 * @return A reference to the slot.
@@ -125,7 +580,98 @@ namespace lsql {
 		Slot& getSlot(const PID& id) const;
 
 		/**
-		 * Resolves a buffer frame within the given slot.
+		 * Returns the frame pool for pages of the given size.
+		 *
+		 * @param pageSize The page size in bytes.
+		 * @return A pointer to the pool, or @c nullptr if there is none.
+		 */
+		FramePool* getPool(size_t pageSize) const;
+
+		/**
+		 * Returns the frame pool containing the given frame.
+		 */
+		FramePool& getPool(const BufferFrame* frame) const;
+
+		/**
+		 * Creates the replacement policy for a frame pool.
+		 *
+		 * @param options The options of the buffer manager.
+		 * @param size    The number of frames in the pool.
+		 */
+		static ReplacementPolicy* createPolicy(const BufferOptions& options, uint64_t size);
+
+		/**
+		 * Resolves a buffer frame and fixes it without locking it. If the
+		 * page is not in memory, it is loaded from disc.
+		 *
+		 * @param id       The id of the page.
+		 * @param ring     An optional ring to recycle frames for scans.
+		 * @param timeout  The maximum time to wait for a frame in microseconds.
+		 * @param writable Whether the page might be modified while fixed.
+		 *
+		 * @return A pointer to the fixed page frame, or @c nullptr.
+		 */
+		BufferFrame* requestPage(const PID& id, BufferRing* ring, uint64_t timeout, bool writable);
+
+		/**
+		 * Resolves the frame of a page in mapped mode and fixes it without
+		 * locking it. If the page has not been mapped, it is handed to the
+		 * replacement policy, which unmaps another page if the buffer is full.
+		 * Only pages which might be modified grow the file.
+		 *
+		 * @param id       The id of the page.
+		 * @param writable Whether the page might be modified while fixed.
+		 *
+		 * @return A pointer to the fixed page frame.
+		 */
+		BufferFrame* requestMappedPage(const PID& id, bool writable);
+
+		/**
+		 * Adds a page to the given ring and pages out the page which drops
+		 * out of the ring, if possible. See @c discardPage.
+		 *
+		 * @param ring The ring of the current scan.
+		 * @param id   The id of the page to add.
+		 */
+		void recordPage(BufferRing& ring, const PID& id);
+
+		/**
+		 * Pages out the specified page and returns its memory to the pool,
+		 * but only if it is not fixed and has not been accessed again since
+		 * it was loaded. See @c ReplacementPolicy::discard.
+		 *
+		 * @param id The id of the page to remove.
+		 */
+		void discardPage(const PID& id);
+
+		/**
+		 * Creates a frame for the given page, inserts it into the page table
+		 * and loads its data from disc. If another thread has loaded the page
+		 * in the meantime, its frame is used instead.
+		 *
+		 * @param slot    A reference to the slot of the page.
+		 * @param id      The id of the page.
+		 * @param timeout The maximum time to wait for a frame in microseconds.
+		 *
+		 * @return A pointer to the fixed page frame, or @c nullptr.
+		 */
+		BufferFrame* loadPage(Slot& slot, const PID& id, uint64_t timeout);
+
+		/**
+		 * Resolves a buffer frame within the given slot. The caller must hold
+		 * a latch on the slot.
+		 *
+		 * @param slot A reference to the slot to search in.
+		 * @param id   The id of the page.
+		 *
+		 * @return A pointer to the page frame, if found; otherwise @c nullptr.
+		 */
+		BufferFrame* findPage(Slot& slot, const PID& id) const;
+
+		/**
+		 * Resolves a buffer frame within the given slot and fixes it, so that
+		 * it cannot be paged out. The slot is only latched in shared mode, so
+		 * concurrent lookups in the same slot do not block each other.
 		 *
 		 * @param slot A reference to the slot to search in.
 		 * @param id   The id of the page.
@@ -135,53 +681,204 @@ namespace lsql {
 		BufferFrame* acquirePage(Slot& slot, const PID& id);
 
 		/**
-		 * Registers an access to the specified page for the page replacement
-		 * algorithm to prevent immediate page outs.
+		 * Assigns a free frame to the given page. If there are no free frames
+		 * left, an old page is written to disk and its frame reused.
+		 *
+		 * The new frame is fixed and exclusively locked, but neither inserted
+		 * into the page table nor tracked by the replacement policy.
+		 *
+		 * If all frames are fixed, this method waits for the given time. See
+		 * @c waitForUnusedPage.
+		 *
+		 * @param id      The id of the page.
+		 * @param timeout The maximum time to wait for a frame in microseconds.
+		 *
+		 * @return A pointer to the new page frame, or @c nullptr.
 		 */
-		void registerPageAccess(BufferFrame* frame);
+		BufferFrame* allocatePage(const PID& id, uint64_t timeout);
 
 		/**
-		 * Creates a new buffer frame and allocates space for the page contents.
-		 * If there is no more memory for new pages, an old page is written to 
-		 * disk and removed from memory first
+		 * Returns a frame created by @c allocatePage which has not been
+		 * inserted into the page table to the free frames.
 		 *
-		 * @param slot A reference to the slot which will contain the frame.
-		 * @param id   The id of the page.
+		 * @param frame A pointer to the unused frame.
+		 */
+		void releasePage(BufferFrame* frame);
+
+		/**
+		 * Decrements the fix count of a frame. If it is no longer fixed,
+		 * threads waiting for a frame are woken up.
+		 */
+		void unpinPage(BufferFrame* frame);
+
+		/**
+		 * Latches a fixed frame and records the time spent waiting for it.
+		 *
+		 * @param frame     A pointer to the fixed frame.
+		 * @param exclusive Whether or not the latch should be exclusive.
+		 * @param update    Whether to latch in update mode instead.
+		 */
+		void lockFrame(BufferFrame* frame, bool exclusive, bool update = false);
+
+		/**
+		 * Takes a free frame of the pool, or pages out a frame chosen by the
+		 * replacement policy of the pool. The frame is returned so that it can
+		 * be reused for another page.
+		 *
+		 * Policies only page out clean frames. If there are none, the coldest
+		 * dirty frames are written without waiting for latches, after the
+		 * policy has been released, and the policy is asked again. Frames
+		 * whose write fails remain in the page table.
+		 *
+		 * @param pool The pool of the page size needed.
+		 * @return An unused frame, or @c nullptr if all frames are fixed.
+		 */
+		BufferFrame* findUnusedPage(FramePool& pool);
+
+		/**
+		 * Waits until a frame is unfixed and returns it like
+		 * @c findUnusedPage. Waiting threads are counted as stalls.
+		 *
+		 * @param pool    The pool of the page size needed.
+		 * @param timeout The maximum time to wait in microseconds.
+		 * @return An unused frame, or @c nullptr after the timeout.
+		 */
+		BufferFrame* waitForUnusedPage(FramePool& pool, uint64_t timeout);
+
+		/**
+		 * Wakes up all threads waiting in @c waitForUnusedPage, if any.
+		 */
+		void wakeStalledThreads();
+
+		/**
+		 * Removes a frame chosen by the replacement policy from memory.
 		 *
-		 * @return A pointer to the new page frame.
+		 * The table slot of the frame is latched exclusively and the fix
+		 * count is checked again. If the frame is still unused and clean, it
+		 * is removed from the page table. Otherwise, it is skipped, as no I/O
+		 * is done while the policy is latched. In mapped mode, the page is
+		 * only unmapped.
+		 *
+		 * @param frame The frame to remove.
+		 * @return True if the frame has been removed; otherwise false.
 		 */
-		BufferFrame* allocatePage(Slot& slot, const PID& id);
+		bool evictFrame(BufferFrame* frame);
 
 		/**
-		 * Finds an unused page according to the page replacement algorithm.
-		 * This method might fail, if there are no unused pages in memory.
-		 * In this case an error message is printed and the function
-		 * exits with code EXIT_CODE_NO_MORE_MEMORY.
-		 * A BufferFrame is returned so that the memory can be reused and no new
-		 * malloc calls needs to be done.
+		 * Writes dirty frames to disc, sorted by page and coalescing adjacent
+		 * pages into runs of up to @c BUFFER_FLUSH_RUN pages. All frames must
+		 * be fixed by the caller and are unfixed afterwards.
+		 *
+		 * While a run is being collected, further frames are only latched if
+		 * they are free, so no thread waits for a latch while holding another.
 		 *
-		 * @return BufferFrame* an unused buffer frame, removed from the queue
+		 * @param frames The fixed frames to write.
+		 * @param wait   Whether to wait for the latch of the first frame in a
+		 *               run. Otherwise, frames locked by others are skipped.
+		 * @param bytes  Optionally accumulates the number of bytes written.
+		 * @return The number of frames written.
 		 */
-		BufferFrame* findUnusedPage();
+		uint64_t writePages(std::vector<BufferFrame*>& frames, bool wait, uint64_t* bytes = nullptr);
 
 		/**
-		 * Finds the last unused page in the given queue and removes it from 
-		 * memory.
+		 * Writes a run of adjacent latched frames with a single call, then
+		 * unlatches and unfixes them and empties the run.
 		 *
-		 * To find the last unused page, this method scans all BufferFrames 
-		 * in this queue in reverse order. To prevent deadlocks, first the table 
-		 * slot of the respective frame is locked (blocking). Then, an exclusive
-		 * lock of the frame is attempted: 
-		 *  - If this lock is successful, the page is removed from all lists and 
-		 *    written to disc. 
-		 *  - Otherwise, the frame is discarded and all locks are freed.
+		 * @param run   The latched and fixed frames of adjacent pages.
+		 * @param bytes Optionally accumulates the number of bytes written.
+		 * @return The number of frames written.
+		 */
+		uint64_t writeRun(std::vector<BufferFrame*>& run, uint64_t* bytes);
+
+		/**
+		 * Fixes all dirty frames in the page table, optionally restricted to
+		 * a single segment.
+		 *
+		 * @param frames  A vector receiving the fixed frames.
+		 * @param all     Whether to collect frames of all segments.
+		 * @param segment The segment to collect, if @c all is false.
+		 */
+		void collectDirtyPages(std::vector<BufferFrame*>& frames, bool all, uint16_t segment);
+
+		/**
+		 * Returns whether any page of the given segment is in memory.
 		 *
-		 * This method might fail to remove a page, if there are no unused
-		 * pages in the given queue.
+		 * @param segment The identifier of the segment.
+		 */
+		bool hasResidentPages(uint16_t segment);
+
+		/**
+		 * Entry point of the background writer thread.
+		 *
+		 * @param arg A pointer to the buffer manager.
+		 */
+		static void* runWriter(void* arg);
+
+		/**
+		 * Entry point of the threads started by @c checkpoint.
+		 *
+		 * @param arg A pointer to the @c FlushTask of the thread.
+		 */
+		static void* runFlush(void* arg);
+
+		/**
+		 * Saves the pages of all frames to the manifest, hottest first.
+		 *
+		 * @return True if the manifest has been written; otherwise false.
+		 */
+		bool saveManifest();
+
+		/**
+		 * Loads the pages listed in the manifest in segment and page order,
+		 * until the buffer is full. Segments get the page size stored in the
+		 * manifest, unless they already hold pages of another size.
+		 */
+		void warmUp();
+
+		/**
+		 * Entry point of the thread warming up the buffer after a restart.
+		 *
+		 * @param arg A pointer to the buffer manager.
+		 */
+		static void* runWarmup(void* arg);
+
+		/**
+		 * Writes dirty frames which are likely to be paged out soon and not
+		 * fixed by any thread. Only the coldest @c cleanTarget frames of each
+		 * queue of the replacement policies are considered.
+		 *
+		 * Frames which are locked exclusively are skipped, so the writer never
+		 * waits for other threads.
+		 *
+		 * @param budget The maximum number of frames to write.
+		 */
+		void flushColdPages(uint64_t budget);
+
+		/**
+		 * Records a page miss for sequential access detection. Once enough
+		 * consecutive pages of a segment have been missed, read ahead is
+		 * started for the following pages.
+		 *
+		 * @param id The id of the missed page.
+		 */
+		void detectSequentialAccess(const PID& id);
+
+		/**
+		 * Entry point of the read ahead I/O threads.
+		 *
+		 * @param arg A pointer to the buffer manager.
+		 */
+		static void* runReadAhead(void* arg);
+
+		/**
+		 * Loads the given pages, if they are not in memory yet. The first page
+		 * is marked, so that accessing it triggers read ahead for the next
+		 * window of pages.
 		 *
-		 * @return True, if a page was freed; otherwise false;
+		 * @param first The first page to load.
+		 * @param count The number of consecutive pages to load.
 		 */
-		BufferFrame* getLastUnusedPage(Queue& queue);
+		void readAhead(const PID& first, uint32_t count);
 
 	};
 
@@ -0,0 +1,36 @@
+//
+//  BufferRing.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+
+#include "BufferRing.h"
+
+namespace lsql {
+
+	BufferRing::BufferRing(size_t capacity)
+	: position(0), capacity(capacity) {
+		assert(capacity > 0);
+	}
+
+	bool BufferRing::add(const PID& id, PID& displaced) {
+		if (pages.size() < capacity) {
+			pages.push_back(id.id);
+			return false;
+		}
+
+		displaced = pages[position];
+		pages[position] = id.id;
+		position = (position + 1) % capacity;
+		return true;
+	}
+
+	size_t BufferRing::getCapacity() const {
+		return capacity;
+	}
+
+}
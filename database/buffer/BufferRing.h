@@ -0,0 +1,64 @@
+//
+//  BufferRing.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "common/IDs.h"
+
+#define BUFFER_RING_SIZE 8
+
+namespace lsql {
+
+	/**
+	 * An access strategy for bulk sequential reads, such as table scans.
+	 *
+	 * A ring remembers the last pages brought into memory by its owner. Once
+	 * a page drops out of the ring, the buffer manager pages it out again,
+	 * unless it has been accessed by someone else in the meantime. Thus, a
+	 * scan only occupies a few frames and does not displace hot pages from
+	 * the buffer. See @c BufferManager::fixPage for more information.
+	 *
+	 * A ring must only be used by one thread at a time.
+	 */
+	class BufferRing {
+
+		std::vector<uint64_t> pages;
+		size_t position;
+		size_t capacity;
+
+	public:
+
+		/**
+		 * Creates a new empty ring.
+		 *
+		 * @param capacity The maximum number of pages in the ring.
+		 */
+		explicit BufferRing(size_t capacity = BUFFER_RING_SIZE);
+
+		/**
+		 * Adds a page to the ring. If the ring is full, the oldest page is
+		 * replaced.
+		 *
+		 * @param id        The id of the new page.
+		 * @param displaced Receives the id of the replaced page, if any.
+		 *
+		 * @return True if a page has been replaced; otherwise false.
+		 */
+		bool add(const PID& id, PID& displaced);
+
+		/**
+		 * Returns the maximum number of pages in this ring.
+		 */
+		size_t getCapacity() const;
+
+	};
+
+}
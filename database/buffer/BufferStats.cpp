@@ -0,0 +1,142 @@
+//
+//  BufferStats.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+
+#include "BufferStats.h"
+
+namespace lsql {
+
+	static const char* COUNTER_NAMES[BUFFER_COUNTERS] = {
+		"hits", "misses", "read ahead", "evictions", "writes", "background writes", "warmup"
+	};
+
+	static const char* LATENCY_NAMES[BUFFER_LATENCIES] = {
+		"lock wait", "load", "save", "stall"
+	};
+
+	static std::atomic<unsigned> nextShard(0);
+
+	double LatencyHistogram::getMean() const {
+		return (count > 0) ? double(sum) / count : 0;
+	}
+
+	uint64_t LatencyHistogram::getPercentile(double percentile) const {
+		uint64_t rank = uint64_t(percentile * count);
+		uint64_t seen = 0;
+
+		for (int i = 0; i < BUFFER_STATS_BUCKETS; ++i) {
+			seen += buckets[i];
+			if (seen > rank)
+				return uint64_t(2) << i;
+		}
+
+		return (count > 0) ? uint64_t(2) << (BUFFER_STATS_BUCKETS - 1) : 0;
+	}
+
+	uint64_t BufferStats::Snapshot::get(BufferCounter counter) const {
+		return counters[counter];
+	}
+
+	const LatencyHistogram& BufferStats::Snapshot::get(BufferLatency latency) const {
+		return latencies[latency];
+	}
+
+	double BufferStats::Snapshot::getHitRatio() const {
+		uint64_t requests = counters[COUNTER_HITS] + counters[COUNTER_MISSES];
+		return (requests > 0) ? double(counters[COUNTER_HITS]) / requests : 0;
+	}
+
+	void BufferStats::Snapshot::print(std::ostream& out) const {
+		std::ios::fmtflags flags = out.flags();
+		out << std::fixed << std::setprecision(2);
+
+		for (int i = 0; i < BUFFER_COUNTERS; ++i)
+			out << std::setw(18) << COUNTER_NAMES[i] << ": " << counters[i] << std::endl;
+		out << std::setw(18) << "hit ratio" << ": " << 100 * getHitRatio() << "%" << std::endl;
+
+		for (int i = 0; i < BUFFER_LATENCIES; ++i) {
+			const LatencyHistogram& histogram = latencies[i];
+			out << std::setw(18) << LATENCY_NAMES[i] << ": " << histogram.count
+			    << " x " << histogram.getMean() / 1000 << " us"
+			    << " (p50 < " << histogram.getPercentile(0.5) / 1000.0 << " us"
+			    << ", p99 < " << histogram.getPercentile(0.99) / 1000.0 << " us)" << std::endl;
+		}
+
+		out.flags(flags);
+	}
+
+	BufferStats::BufferStats() {
+		reset();
+	}
+
+	void BufferStats::count(BufferCounter counter, uint64_t value) {
+		getShard().counters[counter].fetch_add(value, std::memory_order_relaxed);
+	}
+
+	void BufferStats::record(BufferLatency latency, uint64_t duration) {
+		int bucket = 0;
+		while (bucket < BUFFER_STATS_BUCKETS - 1 && (duration >> (bucket + 1)) > 0)
+			bucket++;
+
+		Shard& shard = getShard();
+		shard.counts[latency].fetch_add(1, std::memory_order_relaxed);
+		shard.sums[latency].fetch_add(duration, std::memory_order_relaxed);
+		shard.buckets[latency][bucket].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	BufferStats::Snapshot BufferStats::snapshot() const {
+		Snapshot snapshot;
+		memset(&snapshot, 0, sizeof(snapshot));
+
+		for (const Shard& shard : shards) {
+			for (int i = 0; i < BUFFER_COUNTERS; ++i)
+				snapshot.counters[i] += shard.counters[i].load(std::memory_order_relaxed);
+
+			for (int i = 0; i < BUFFER_LATENCIES; ++i) {
+				LatencyHistogram& histogram = snapshot.latencies[i];
+				histogram.count += shard.counts[i].load(std::memory_order_relaxed);
+				histogram.sum += shard.sums[i].load(std::memory_order_relaxed);
+
+				for (int j = 0; j < BUFFER_STATS_BUCKETS; ++j)
+					histogram.buckets[j] += shard.buckets[i][j].load(std::memory_order_relaxed);
+			}
+		}
+
+		return snapshot;
+	}
+
+	void BufferStats::reset() {
+		for (Shard& shard : shards) {
+			for (int i = 0; i < BUFFER_COUNTERS; ++i)
+				shard.counters[i].store(0, std::memory_order_relaxed);
+
+			for (int i = 0; i < BUFFER_LATENCIES; ++i) {
+				shard.counts[i].store(0, std::memory_order_relaxed);
+				shard.sums[i].store(0, std::memory_order_relaxed);
+
+				for (int j = 0; j < BUFFER_STATS_BUCKETS; ++j)
+					shard.buckets[i][j].store(0, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	uint64_t BufferStats::now() {
+		auto time = std::chrono::steady_clock::now().time_since_epoch();
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+	}
+
+	BufferStats::Shard& BufferStats::getShard() {
+		// Threads are assigned to shards round robin on their first update
+		static thread_local unsigned shard = nextShard++ % BUFFER_STATS_SHARDS;
+		return shards[shard];
+	}
+
+}
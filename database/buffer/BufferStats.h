@@ -0,0 +1,190 @@
+//
+//  BufferStats.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+#define BUFFER_STATS_SHARDS 32
+#define BUFFER_STATS_BUCKETS 48
+
+namespace lsql {
+
+	/**
+	 * Events counted by a buffer manager.
+	 */
+	enum BufferCounter {
+		/** Page requests which found the page in memory. */
+		COUNTER_HITS = 0,
+		/** Page requests which had to load the page. */
+		COUNTER_MISSES,
+		/** Pages loaded by read ahead. */
+		COUNTER_READ_AHEAD,
+		/** Frames paged out by the replacement policy. */
+		COUNTER_EVICTIONS,
+		/** Dirty frames written to disc. */
+		COUNTER_WRITES,
+		/** Dirty frames written to disc by the background writer. */
+		COUNTER_BACKGROUND_WRITES,
+		/** Pages loaded from the page manifest after a restart. */
+		COUNTER_WARMUP,
+		BUFFER_COUNTERS
+	};
+
+	/**
+	 * Durations measured by a buffer manager.
+	 */
+	enum BufferLatency {
+		/** Time spent waiting for a frame latch in @c fixPage. Uncontended
+		 *  latches are not measured. */
+		LATENCY_LOCK_WAIT = 0,
+		/** Time spent reading a page from disc. */
+		LATENCY_LOAD,
+		/** Time spent writing a page to disc. */
+		LATENCY_SAVE,
+		/** Time spent waiting for a frame, because all frames were fixed. */
+		LATENCY_STALL,
+		BUFFER_LATENCIES
+	};
+
+	/**
+	 * A histogram of durations with logarithmic buckets. Bucket @c i counts
+	 * durations of less than 2^(i+1) nanoseconds.
+	 */
+	struct LatencyHistogram {
+
+		uint64_t count;
+		uint64_t sum;
+		uint64_t buckets[BUFFER_STATS_BUCKETS];
+
+		/**
+		 * Returns the average duration in nanoseconds.
+		 */
+		double getMean() const;
+
+		/**
+		 * Returns an upper bound for the given percentile in nanoseconds.
+		 *
+		 * @param percentile A value between 0 and 1.
+		 */
+		uint64_t getPercentile(double percentile) const;
+
+	};
+
+	/**
+	 * Collects statistics of a buffer manager with low overhead.
+	 *
+	 * All values are kept in several shards, and each thread only updates the
+	 * shard assigned to it. Thus, threads do not contend on shared cache lines
+	 * unless there are more threads than shards. Reading the statistics sums
+	 * up all shards.
+	 */
+	class BufferStats {
+
+		/**
+		 * Statistics updated by a subset of all threads.
+		 */
+		struct Shard {
+			std::atomic<uint64_t> counters[BUFFER_COUNTERS];
+			std::atomic<uint64_t> counts[BUFFER_LATENCIES];
+			std::atomic<uint64_t> sums[BUFFER_LATENCIES];
+			std::atomic<uint64_t> buckets[BUFFER_LATENCIES][BUFFER_STATS_BUCKETS];
+			char padding[64];
+		};
+
+		Shard shards[BUFFER_STATS_SHARDS];
+
+	public:
+
+		/**
+		 * A consistent copy of all statistics.
+		 */
+		struct Snapshot {
+
+			uint64_t counters[BUFFER_COUNTERS];
+			LatencyHistogram latencies[BUFFER_LATENCIES];
+
+			/**
+			 * Returns the value of the given counter.
+			 */
+			uint64_t get(BufferCounter counter) const;
+
+			/**
+			 * Returns the histogram of the given duration.
+			 */
+			const LatencyHistogram& get(BufferLatency latency) const;
+
+			/**
+			 * Returns the share of page requests which found the page in
+			 * memory, or zero if there were no requests.
+			 */
+			double getHitRatio() const;
+
+			/**
+			 * Prints all statistics in a human readable format.
+			 */
+			void print(std::ostream& out) const;
+
+		};
+
+		/**
+		 * Creates empty statistics.
+		 */
+		BufferStats();
+
+		/** Prevent the copy constructor. */
+		BufferStats(const BufferStats& other) = delete;
+
+		/** Prevent copy assignments. */
+		BufferStats& operator=(const BufferStats& other) = delete;
+
+		/**
+		 * Increments a counter.
+		 *
+		 * @param counter The counter to increment.
+		 * @param value   The value to add.
+		 */
+		void count(BufferCounter counter, uint64_t value = 1);
+
+		/**
+		 * Adds a duration to a histogram.
+		 *
+		 * @param latency  The histogram to update.
+		 * @param duration The duration in nanoseconds.
+		 */
+		void record(BufferLatency latency, uint64_t duration);
+
+		/**
+		 * Sums up the statistics of all threads. Values updated concurrently
+		 * might or might not be included.
+		 */
+		Snapshot snapshot() const;
+
+		/**
+		 * Resets all statistics to zero. Values updated concurrently might
+		 * get lost.
+		 */
+		void reset();
+
+		/**
+		 * Returns a monotonic timestamp in nanoseconds for measuring durations.
+		 */
+		static uint64_t now();
+
+	private:
+
+		/**
+		 * Returns the shard of the calling thread.
+		 */
+		Shard& getShard();
+
+	};
+
+}
@@ -0,0 +1,90 @@
+//
+//  ClockPolicy.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "ClockPolicy.h"
+
+namespace lsql {
+
+	ClockPolicy::ClockPolicy() {
+	}
+
+	const char* ClockPolicy::getName() const {
+		return "CLOCK";
+	}
+
+	void ClockPolicy::insert(BufferFrame* frame) {
+		ring.lock(true);
+		frame->queue = QUEUE_A1;
+		ring.append(frame);
+		ring.unlock();
+	}
+
+	void ClockPolicy::access(BufferFrame* frame) {
+		// Avoid writing to shared cache lines of hot frames
+		if (!frame->referenced.load(std::memory_order_relaxed))
+			frame->referenced.store(true, std::memory_order_relaxed);
+	}
+
+	BufferFrame* ClockPolicy::evict(FrameEvictor& evictor) {
+		ring.lock(true);
+
+		// After one full sweep, all reference bits are cleared. Frames are
+		// never written here, the evictor skips dirty ones.
+		uint64_t steps = 2 * ring.getSize();
+		for (uint64_t i = 0; i < steps; ++i) {
+			BufferFrame* frame = ring.getFirst();
+			if (frame->fixCount == 0 && !frame->referenced && evictor.evictFrame(frame)) {
+				ring.remove(frame);
+				frame->queue = QUEUE_NONE;
+				ring.unlock();
+				return frame;
+			}
+
+			frame->referenced = false;
+			ring.remove(frame);
+			ring.append(frame);
+		}
+
+		ring.unlock();
+		return nullptr;
+	}
+
+	bool ClockPolicy::discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor) {
+		ring.lock(true);
+		bool removed = frame->queue == QUEUE_A1 && !frame->referenced && evictFrame(ring, frame, id, evictor);
+		ring.unlock();
+
+		return removed;
+	}
+
+	void ClockPolicy::collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget) {
+		// The frames in front of the hand are inspected next
+		ring.lock(false);
+
+		BufferFrame* frame = ring.getFirst();
+		for (uint64_t i = 0; frame != nullptr && i < window && frames.size() < budget; ++i) {
+			if (frame->isDirty() && frame->fixCount == 0) {
+				frame->fixCount++;
+				frames.push_back(frame);
+			}
+
+			frame = frame->queueNext;
+		}
+
+		ring.unlock();
+	}
+
+	void ClockPolicy::collectPages(std::vector<PID>& pages) {
+		// The frames behind the hand have been passed over most recently
+		ring.lock(false);
+		for (BufferFrame* frame = ring.getLast(); frame != nullptr; frame = frame->queuePrev)
+			pages.push_back(frame->getId());
+		ring.unlock();
+	}
+
+}
@@ -0,0 +1,47 @@
+//
+//  ClockPolicy.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include "ReplacementPolicy.h"
+
+namespace lsql {
+
+	/**
+	 * CLOCK page replacement (second chance).
+	 *
+	 * All frames form a ring, and accesses only set the reference bit of a
+	 * frame without any latching. The clock hand is always the first frame of
+	 * the queue: to advance it, the first frame is moved to the end. Thus, new
+	 * frames are appended right behind the hand.
+	 *
+	 * To find a victim, the hand sweeps over the ring and clears all reference
+	 * bits until it finds an unfixed frame which has not been referenced.
+	 */
+	class ClockPolicy : public ReplacementPolicy {
+
+		FrameQueue ring;
+
+	public:
+
+		/**
+		 * Creates a new policy.
+		 */
+		ClockPolicy();
+
+		const char* getName() const;
+		void insert(BufferFrame* frame);
+		void access(BufferFrame* frame);
+		BufferFrame* evict(FrameEvictor& evictor);
+		bool discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor);
+		void collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget);
+		void collectPages(std::vector<PID>& pages);
+
+	};
+
+}
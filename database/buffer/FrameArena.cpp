@@ -0,0 +1,73 @@
+//
+//  FrameArena.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+#include <new>
+#include <sys/mman.h>
+
+#include "FrameArena.h"
+
+namespace lsql {
+
+	FrameArena::FrameArena(uint64_t count, bool hugePages, size_t pageSize)
+	: memory(MAP_FAILED), length(count * pageSize), pageSize(pageSize), count(count), hugePages(false) {
+		assert(count > 0);
+
+#ifdef MAP_HUGETLB
+		if (hugePages) {
+			// Huge page mappings have to be a multiple of the huge page size
+			size_t hugeLength = (length + FRAME_ARENA_HUGE_PAGE_SIZE - 1) & ~(FRAME_ARENA_HUGE_PAGE_SIZE - 1);
+			memory = mmap(nullptr, hugeLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if (memory != MAP_FAILED) {
+				length = hugeLength;
+				this->hugePages = true;
+			}
+		}
+#endif
+
+		if (memory == MAP_FAILED) {
+			memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			assert(memory != MAP_FAILED);
+
+#ifdef MADV_HUGEPAGE
+			if (hugePages)
+				this->hugePages = madvise(memory, length, MADV_HUGEPAGE) == 0;
+#endif
+		}
+
+		frames = static_cast<BufferFrame*>(::operator new(count * sizeof(BufferFrame)));
+		for (uint64_t i = 0; i < count; ++i)
+			new (&frames[i]) BufferFrame(static_cast<char*>(memory) + i * pageSize, pageSize);
+	}
+
+	FrameArena::~FrameArena() {
+		for (uint64_t i = 0; i < count; ++i)
+			frames[i].~BufferFrame();
+
+		::operator delete(frames);
+		munmap(memory, length);
+	}
+
+	uint64_t FrameArena::getCount() const {
+		return count;
+	}
+
+	size_t FrameArena::getPageSize() const {
+		return pageSize;
+	}
+
+	BufferFrame& FrameArena::getFrame(uint64_t index) const {
+		assert(index < count);
+		return frames[index];
+	}
+
+	bool FrameArena::usesHugePages() const {
+		return hugePages;
+	}
+
+}
@@ -0,0 +1,89 @@
+//
+//  FrameArena.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "BufferFrame.h"
+
+#define FRAME_ARENA_HUGE_PAGE_SIZE (size_t(2) << 20)
+
+namespace lsql {
+
+	/**
+	 * Owns the memory of all frames of one page size in a buffer manager.
+	 *
+	 * The page data of all frames is reserved up front in one contiguous,
+	 * page aligned mapping, and the frame descriptors are kept in a fixed
+	 * array. Descriptors are never freed while the arena exists; the buffer
+	 * manager reuses them in place for different pages.
+	 *
+	 * If requested, the mapping is backed by huge pages to reduce TLB misses.
+	 * Explicit huge pages (@c MAP_HUGETLB) are tried first. If none are
+	 * reserved by the system, transparent huge pages are requested via
+	 * @c madvise instead. Platforms without either use regular pages.
+	 */
+	class FrameArena {
+
+		void* memory;
+		size_t length;
+		size_t pageSize;
+		BufferFrame* frames;
+		uint64_t count;
+		bool hugePages;
+
+	public:
+
+		/**
+		 * Reserves memory for the given number of frames and creates their
+		 * descriptors. Initially, no frame is assigned to a page.
+		 *
+		 * @param count     The number of frames.
+		 * @param hugePages Whether to back the memory with huge pages.
+		 * @param pageSize  The size of each frame in bytes.
+		 */
+		FrameArena(uint64_t count, bool hugePages, size_t pageSize = BufferFrame::SIZE);
+
+		/** Prevent the copy constructor. */
+		FrameArena(const FrameArena& other) = delete;
+
+		/** Prevent copy assignments. */
+		FrameArena& operator=(const FrameArena& other) = delete;
+
+		/**
+		 * Destroys all frame descriptors and releases the memory. Dirty frames
+		 * are written to disc before.
+		 */
+		~FrameArena();
+
+		/**
+		 * Returns the number of frames in this arena.
+		 */
+		uint64_t getCount() const;
+
+		/**
+		 * Returns the size of each frame in this arena in bytes.
+		 */
+		size_t getPageSize() const;
+
+		/**
+		 * Returns the frame descriptor at the given index.
+		 */
+		BufferFrame& getFrame(uint64_t index) const;
+
+		/**
+		 * Returns whether the memory is backed by huge pages, either explicitly
+		 * or transparently.
+		 */
+		bool usesHugePages() const;
+
+	};
+
+}
@@ -0,0 +1,181 @@
+//
+//  LruKPolicy.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <algorithm>
+
+#include "LruKPolicy.h"
+
+#define LRU_K (BUFFER_FRAME_HISTORY - 1)
+#define LRU_K_COMPLETE (1ull << 63)
+
+namespace lsql {
+
+	LruKPolicy::LruKPolicy()
+	: clock(0) {
+	}
+
+	const char* LruKPolicy::getName() const {
+		return "LRU-K";
+	}
+
+	void LruKPolicy::insert(BufferFrame* frame) {
+		latch.lock(true);
+		frame->history[0] = ++clock;
+		frame->queue = QUEUE_A1;
+		push(Entry{ getKey(frame), frame });
+		latch.unlock();
+	}
+
+	void LruKPolicy::access(BufferFrame* frame) {
+		// Concurrent hits on the same frame may interleave, which only blurs
+		// its history. The heap is not touched, so no latch is needed.
+		uint64_t now = ++clock;
+		for (int i = LRU_K; i > 0; --i)
+			frame->history[i].store(frame->history[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		frame->history[0].store(now, std::memory_order_relaxed);
+	}
+
+	BufferFrame* LruKPolicy::evict(FrameEvictor& evictor) {
+		latch.lock(true);
+
+		BufferFrame* victim = nullptr;
+		std::vector<Entry> skipped;
+
+		while (!heap.empty()) {
+			Entry top = heap[0];
+
+			// Accessed frames are sifted down with their current key first
+			uint64_t key = getKey(top.frame);
+			if (key != top.key) {
+				top.frame->queue = (key & LRU_K_COMPLETE) ? QUEUE_AM : QUEUE_A1;
+				heap[0].key = key;
+				siftDown(0);
+				continue;
+			}
+
+			// The evictor checks again, as the frame might have been fixed
+			remove(0);
+			if (top.frame->fixCount == 0 && evictor.evictFrame(top.frame)) {
+				top.frame->queue = QUEUE_NONE;
+				victim = top.frame;
+				break;
+			}
+
+			skipped.push_back(top);
+		}
+
+		for (const Entry& entry : skipped)
+			push(entry);
+
+		latch.unlock();
+		return victim;
+	}
+
+	bool LruKPolicy::discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor) {
+		latch.lock(true);
+
+		// A tracked frame cannot be assigned to another page
+		bool removed = frame->queue != QUEUE_NONE && frame->history[LRU_K] == 0 && frame->getId() == id
+			&& frame->fixCount == 0 && evictor.evictFrame(frame);
+
+		if (removed) {
+			remove(frame->heapIndex);
+			frame->queue = QUEUE_NONE;
+		}
+
+		latch.unlock();
+		return removed;
+	}
+
+	void LruKPolicy::collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget) {
+		// The front of the heap array holds its upper levels, which are the
+		// coldest frames apart from lazily updated keys.
+		latch.lock(false);
+
+		uint64_t count = std::min<uint64_t>(window, heap.size());
+		for (uint64_t i = 0; i < count && frames.size() < budget; ++i) {
+			BufferFrame* frame = heap[i].frame;
+			if (frame->isDirty() && frame->fixCount == 0) {
+				frame->fixCount++;
+				frames.push_back(frame);
+			}
+		}
+
+		latch.unlock();
+	}
+
+	void LruKPolicy::collectPages(std::vector<PID>& pages) {
+		latch.lock(false);
+		std::vector<Entry> entries(heap);
+		latch.unlock();
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key > b.key; });
+		for (const Entry& entry : entries)
+			pages.push_back(entry.frame->getId());
+	}
+
+	uint64_t LruKPolicy::getKey(const BufferFrame* frame) {
+		uint64_t last = frame->history[LRU_K].load(std::memory_order_relaxed);
+		return (last != 0) ? (last | LRU_K_COMPLETE) : frame->history[0].load(std::memory_order_relaxed);
+	}
+
+	void LruKPolicy::push(const Entry& entry) {
+		heap.push_back(entry);
+		place(heap.size() - 1, entry);
+		siftUp(heap.size() - 1);
+	}
+
+	void LruKPolicy::remove(uint64_t index) {
+		Entry last = heap.back();
+		heap.pop_back();
+		if (index == heap.size())
+			return;
+
+		place(index, last);
+		siftUp(index);
+		siftDown(index);
+	}
+
+	void LruKPolicy::siftUp(uint64_t index) {
+		Entry entry = heap[index];
+		while (index > 0) {
+			uint64_t parent = (index - 1) / 2;
+			if (heap[parent].key <= entry.key)
+				break;
+
+			place(index, heap[parent]);
+			index = parent;
+		}
+
+		place(index, entry);
+	}
+
+	void LruKPolicy::siftDown(uint64_t index) {
+		Entry entry = heap[index];
+		uint64_t size = heap.size();
+
+		while (2 * index + 1 < size) {
+			uint64_t child = 2 * index + 1;
+			if (child + 1 < size && heap[child + 1].key < heap[child].key)
+				child++;
+			if (entry.key <= heap[child].key)
+				break;
+
+			place(index, heap[child]);
+			index = child;
+		}
+
+		place(index, entry);
+	}
+
+	void LruKPolicy::place(uint64_t index, const Entry& entry) {
+		heap[index] = entry;
+		entry.frame->heapIndex = index;
+	}
+
+}
@@ -0,0 +1,98 @@
+//
+//  LruKPolicy.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+
+#include "utils/Latch.h"
+#include "ReplacementPolicy.h"
+
+namespace lsql {
+
+	/**
+	 * LRU-K page replacement with K = @c BUFFER_FRAME_HISTORY.
+	 *
+	 * Each frame records the logical times of its last K accesses. The victim
+	 * is the frame whose K-th most recent access lies furthest in the past.
+	 * Frames with less than K accesses have an infinite backward distance and
+	 * are paged out first, in LRU order.
+	 *
+	 * All frames are kept in a binary min-heap ordered by their backward
+	 * distance. Hits only update the history of the frame without latching,
+	 * the heap is reordered lazily when a victim is chosen. As keys never
+	 * decrease, an entry whose key is still current at the top of the heap
+	 * is the actual victim. The heap is guarded by @c latch.
+	 */
+	class LruKPolicy : public ReplacementPolicy {
+
+		/**
+		 * A frame in the heap and its key at the time it was last sifted.
+		 */
+		struct Entry {
+			uint64_t key;
+			BufferFrame* frame;
+		};
+
+		std::atomic<uint64_t> clock;
+		std::vector<Entry> heap;
+		Latch latch;
+
+	public:
+
+		/**
+		 * Creates a new policy.
+		 */
+		LruKPolicy();
+
+		const char* getName() const;
+		void insert(BufferFrame* frame);
+		void access(BufferFrame* frame);
+		BufferFrame* evict(FrameEvictor& evictor);
+		bool discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor);
+		void collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget);
+		void collectPages(std::vector<PID>& pages);
+
+	private:
+
+		/**
+		 * Returns the current heap key of a frame. Frames with less than K
+		 * accesses are ordered by their last access and precede all others.
+		 */
+		static uint64_t getKey(const BufferFrame* frame);
+
+		/**
+		 * Appends an entry to the heap and restores the heap order.
+		 */
+		void push(const Entry& entry);
+
+		/**
+		 * Removes the entry at the given position from the heap.
+		 */
+		void remove(uint64_t index);
+
+		/**
+		 * Moves the entry at the given position up until the heap order is
+		 * restored.
+		 */
+		void siftUp(uint64_t index);
+
+		/**
+		 * Moves the entry at the given position down until the heap order is
+		 * restored.
+		 */
+		void siftDown(uint64_t index);
+
+		/**
+		 * Stores an entry at the given position and updates its frame.
+		 */
+		void place(uint64_t index, const Entry& entry);
+
+	};
+
+}
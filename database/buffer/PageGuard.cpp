@@ -0,0 +1,71 @@
+//
+//  PageGuard.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "BufferManager.h"
+#include "PageGuard.h"
+
+namespace lsql {
+
+	PageGuard::PageGuard()
+	: bufferManager(nullptr), frame(nullptr) {
+	}
+
+	PageGuard::PageGuard(BufferManager& bufferManager, BufferFrame& frame)
+	: bufferManager(&bufferManager), frame(&frame) {
+	}
+
+	PageGuard::PageGuard(const PageGuard& other)
+	: bufferManager(other.bufferManager), frame(other.frame) {
+		if (frame != nullptr)
+			bufferManager->refixPage(*frame);
+	}
+
+	PageGuard::PageGuard(PageGuard&& other)
+	: bufferManager(other.bufferManager), frame(other.frame) {
+		other.frame = nullptr;
+	}
+
+	PageGuard::~PageGuard() {
+		release();
+	}
+
+	PageGuard& PageGuard::operator=(const PageGuard& other) {
+		// Fix the new frame first, in case it is the current one
+		if (other.frame != nullptr)
+			other.bufferManager->refixPage(*other.frame);
+
+		release();
+		bufferManager = other.bufferManager;
+		frame = other.frame;
+		return *this;
+	}
+
+	PageGuard& PageGuard::operator=(PageGuard&& other) {
+		if (this != &other) {
+			release();
+			bufferManager = other.bufferManager;
+			frame = other.frame;
+			other.frame = nullptr;
+		}
+
+		return *this;
+	}
+
+	BufferFrame* PageGuard::getFrame() const {
+		return frame;
+	}
+
+	void PageGuard::release() {
+		if (frame == nullptr)
+			return;
+
+		bufferManager->unfixPage(*frame, false);
+		frame = nullptr;
+	}
+
+}
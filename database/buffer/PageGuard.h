@@ -0,0 +1,88 @@
+//
+//  PageGuard.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include "BufferFrame.h"
+
+namespace lsql {
+
+	class BufferManager;
+
+	/**
+	 * Keeps a page fixed in shared mode for the lifetime of the guard.
+	 *
+	 * A guard adopts a frame which has been fixed by @c BufferManager::fixPage
+	 * and unfixes it when destroyed. Copies of a guard fix the frame again
+	 * via @c BufferManager::refixPage, which neither allocates nor looks up
+	 * the page table, so they are cheap enough to hand out per tuple.
+	 *
+	 * While a guard exists, the page can neither be paged out nor modified.
+	 * A thread must therefore release its guards before fixing the same page
+	 * exclusively.
+	 */
+	class PageGuard {
+
+		BufferManager* bufferManager;
+		BufferFrame* frame;
+
+	public:
+
+		/**
+		 * Creates an empty guard, which does not keep any page fixed.
+		 */
+		PageGuard();
+
+		/**
+		 * Takes over a frame fixed in shared mode by the caller.
+		 *
+		 * @param bufferManager The buffer manager owning the frame.
+		 * @param frame         The fixed frame.
+		 */
+		PageGuard(BufferManager& bufferManager, BufferFrame& frame);
+
+		/**
+		 * Fixes the frame of the other guard again.
+		 */
+		PageGuard(const PageGuard& other);
+
+		/**
+		 * Takes over the frame of the other guard, which becomes empty.
+		 */
+		PageGuard(PageGuard&& other);
+
+		/**
+		 * Unfixes the frame, if any.
+		 */
+		~PageGuard();
+
+		/**
+		 * Releases the current frame and fixes the frame of the other guard.
+		 */
+		PageGuard& operator=(const PageGuard& other);
+
+		/**
+		 * Releases the current frame and takes over the frame of the other
+		 * guard, which becomes empty.
+		 */
+		PageGuard& operator=(PageGuard&& other);
+
+		/**
+		 * Returns the guarded frame, or @c nullptr if the guard is empty.
+		 */
+		BufferFrame* getFrame() const;
+
+		/**
+		 * Unfixes the frame before the guard is destroyed. Afterwards, the
+		 * guard is empty.
+		 */
+		void release();
+
+	};
+
+}
@@ -0,0 +1,59 @@
+//
+//  PageManifest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cstdio>
+#include <unistd.h>
+
+#include "utils/File.h"
+#include "PageManifest.h"
+
+namespace lsql {
+
+	bool PageManifest::save(const std::string& path, const std::vector<Entry>& pages) {
+		std::string temporary = path + ".tmp";
+
+		std::vector<uint64_t> words;
+		words.reserve(1 + 2 * pages.size());
+		words.push_back(PAGE_MANIFEST_MAGIC);
+		for (const Entry& entry : pages) {
+			words.push_back(entry.id.id);
+			words.push_back(entry.pageSize);
+		}
+
+		File<uint64_t> file(temporary, true);
+		if (!file.allocate(0) || !file.writeVector(words))
+			return false;
+
+		file.close();
+		return std::rename(temporary.c_str(), path.c_str()) == 0;
+	}
+
+	bool PageManifest::load(const std::string& path, std::vector<Entry>& pages) {
+		// Opening a missing file would create it
+		if (access(path.c_str(), R_OK) != 0)
+			return false;
+
+		File<uint64_t> file(path);
+
+		std::vector<uint64_t> words;
+		if (!file.readVector(words, file.size() / sizeof(uint64_t)))
+			return false;
+
+		// Older manifests list page ids only
+		if (words.empty() || words[0] != PAGE_MANIFEST_MAGIC || words.size() % 2 == 0)
+			return false;
+
+		pages.clear();
+		pages.reserve(words.size() / 2);
+		for (size_t i = 1; i < words.size(); i += 2)
+			pages.push_back(Entry{ PID(words[i]), words[i + 1] });
+
+		return true;
+	}
+
+}
@@ -0,0 +1,69 @@
+//
+//  PageManifest.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/IDs.h"
+
+/**
+ * The first word of a manifest. Files without it are not loaded.
+ */
+#define PAGE_MANIFEST_MAGIC 0x4c53514c4d414e32
+
+namespace lsql {
+
+	/**
+	 * Persists the pages held by a buffer manager, so that they can be loaded
+	 * again after a restart.
+	 *
+	 * The manifest starts with @c PAGE_MANIFEST_MAGIC, followed by pairs of
+	 * 64 bit page ids and page sizes, hottest first. Storing the page size
+	 * allows loading pages before the catalog has set the page sizes of its
+	 * segments. The manifest is written to a temporary file and renamed
+	 * afterwards, so a crash while saving never leaves a truncated manifest
+	 * behind.
+	 */
+	class PageManifest {
+
+	public:
+
+		/**
+		 * A page listed in the manifest.
+		 */
+		struct Entry {
+			PID id;
+			uint64_t pageSize;
+		};
+
+		/**
+		 * Replaces the manifest at the given location.
+		 *
+		 * @param path  The path of the manifest file.
+		 * @param pages The pages to store, hottest first.
+		 *
+		 * @return True if the manifest has been written; otherwise false.
+		 */
+		static bool save(const std::string& path, const std::vector<Entry>& pages);
+
+		/**
+		 * Reads a manifest created by @c save.
+		 *
+		 * @param path  The path of the manifest file.
+		 * @param pages Receives the stored pages, hottest first.
+		 *
+		 * @return True if the manifest exists and has been read; otherwise
+		 *         false. Manifests without page sizes are not read.
+		 */
+		static bool load(const std::string& path, std::vector<Entry>& pages);
+
+	};
+
+}
@@ -0,0 +1,203 @@
+//
+//  PageMapping.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <sys/mman.h>
+
+#include "PageMapping.h"
+
+namespace lsql {
+
+	PageMapping::PageMapping(SegmentFiles& files, uint64_t pages)
+	: files(files), pages((pages + PAGE_MAPPING_CHUNK - 1) / PAGE_MAPPING_CHUNK * PAGE_MAPPING_CHUNK) {
+		segments = new std::atomic<Segment*>[PAGE_MAPPING_SEGMENTS]();
+	}
+
+	PageMapping::~PageMapping() {
+		for (uint64_t i = 0; i < PAGE_MAPPING_SEGMENTS; ++i) {
+			Segment* segment = segments[i];
+			if (segment == nullptr)
+				continue;
+
+			for (uint64_t chunk = 0; chunk < pages / PAGE_MAPPING_CHUNK; ++chunk) {
+				BufferFrame* frames = segment->chunks[chunk];
+				if (frames == nullptr)
+					continue;
+
+				for (uint64_t j = 0; j < PAGE_MAPPING_CHUNK; ++j)
+					frames[j].~BufferFrame();
+				::operator delete(frames);
+			}
+
+			munmap(segment->base, pages * segment->pageSize);
+			delete[] segment->chunks;
+			delete segment;
+		}
+
+		delete[] segments;
+	}
+
+	BufferFrame* PageMapping::getFrame(const PID& id, bool writable) {
+		assert(id.page() < pages);
+		Segment& segment = getSegment(id.segment());
+
+		if (writable && id.page() >= segment.filePages.load(std::memory_order_acquire))
+			extend(segment, id.page());
+
+		uint64_t chunk = id.page() / PAGE_MAPPING_CHUNK;
+		BufferFrame* frames = segment.chunks[chunk].load(std::memory_order_acquire);
+		if (frames == nullptr)
+			frames = createChunk(segment, id.segment(), chunk);
+
+		return &frames[id.page() % PAGE_MAPPING_CHUNK];
+	}
+
+	void PageMapping::prefetch(const PID& first, uint32_t count) {
+		Segment& segment = getSegment(first.segment());
+
+		// Pages beyond the end of the file cannot be loaded
+		uint64_t end = std::min<uint64_t>(uint64_t(first.page()) + count, segment.filePages);
+		if (first.page() >= end)
+			return;
+
+		char* data = segment.base + uint64_t(first.page()) * segment.pageSize;
+		madvise(data, (end - first.page()) * segment.pageSize, MADV_WILLNEED);
+	}
+
+	void PageMapping::release(BufferFrame* frame) {
+		madvise(frame->getData(), frame->getSize(), MADV_DONTNEED);
+	}
+
+	uint64_t PageMapping::sync(bool all, uint16_t segment, uint64_t* bytes) {
+		if (bytes != nullptr)
+			*bytes = 0;
+
+		if (!all)
+			return syncSegment(getSegment(segment), bytes);
+
+		uint64_t written = 0;
+		for (uint64_t i = 0; i < PAGE_MAPPING_SEGMENTS; ++i) {
+			Segment* mapped = segments[i].load(std::memory_order_acquire);
+			if (mapped != nullptr)
+				written += syncSegment(*mapped, bytes);
+		}
+
+		return written;
+	}
+
+	bool PageMapping::isMapped(uint16_t segment) {
+		return segments[segment].load(std::memory_order_acquire) != nullptr;
+	}
+
+	PageMapping::Segment& PageMapping::getSegment(uint16_t id) {
+		Segment* segment = segments[id].load(std::memory_order_acquire);
+		if (segment != nullptr)
+			return *segment;
+
+		mapMutex.lock();
+
+		// Another thread might have mapped the segment in the meantime
+		segment = segments[id].load(std::memory_order_relaxed);
+		if (segment == nullptr) {
+			segment = new Segment();
+			segment->file = &files.get(id);
+			segment->pageSize = files.getPageSize(id);
+			segment->filePages = segment->file->size() / segment->pageSize;
+			segment->chunks = new std::atomic<BufferFrame*>[pages / PAGE_MAPPING_CHUNK]();
+
+			// Pages beyond the end of the file read as zeros until it grows
+			void* base = mmap(nullptr, pages * segment->pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			assert(base != MAP_FAILED);
+			segment->base = static_cast<char*>(base);
+			mapFile(*segment, 0, std::min<uint64_t>(segment->filePages, pages));
+
+			segments[id].store(segment, std::memory_order_release);
+		}
+
+		mapMutex.unlock();
+		return *segment;
+	}
+
+	BufferFrame* PageMapping::createChunk(Segment& segment, uint16_t id, uint64_t chunk) {
+		BufferFrame* frames = static_cast<BufferFrame*>(::operator new(sizeof(BufferFrame) * PAGE_MAPPING_CHUNK));
+
+		for (uint64_t i = 0; i < PAGE_MAPPING_CHUNK; ++i) {
+			uint64_t page = chunk * PAGE_MAPPING_CHUNK + i;
+			new (&frames[i]) BufferFrame(segment.base + page * segment.pageSize, segment.pageSize);
+			frames[i].reset(PID(id, uint32_t(page)), *segment.file);
+		}
+
+		// Discard the chunk, if another thread was faster
+		BufferFrame* existing = nullptr;
+		if (segment.chunks[chunk].compare_exchange_strong(existing, frames))
+			return frames;
+
+		for (uint64_t i = 0; i < PAGE_MAPPING_CHUNK; ++i)
+			frames[i].~BufferFrame();
+		::operator delete(frames);
+
+		return existing;
+	}
+
+	void PageMapping::extend(Segment& segment, uint32_t page) {
+		segment.growMutex.lock();
+
+		if (page >= segment.filePages) {
+			uint64_t filePages = (uint64_t(page) / PAGE_MAPPING_GROWTH + 1) * PAGE_MAPPING_GROWTH;
+			bool success = segment.file->allocate(off_t(filePages * segment.pageSize));
+			assert(success);
+			(void) success;
+
+			mapFile(segment, segment.filePages, std::min<uint64_t>(filePages, pages));
+			segment.filePages.store(filePages, std::memory_order_release);
+		}
+
+		segment.growMutex.unlock();
+	}
+
+	void PageMapping::mapFile(Segment& segment, uint64_t first, uint64_t end) {
+		if (first >= end)
+			return;
+
+		off_t offset = off_t(first * segment.pageSize);
+		void* data = mmap(segment.base + offset, (end - first) * segment.pageSize, PROT_READ | PROT_WRITE,
+		                  MAP_SHARED | MAP_FIXED, segment.file->descriptor(), offset);
+		assert(data != MAP_FAILED);
+		(void) data;
+	}
+
+	uint64_t PageMapping::syncSegment(Segment& segment, uint64_t* bytes) {
+		uint64_t written = 0;
+
+		for (uint64_t chunk = 0; chunk < pages / PAGE_MAPPING_CHUNK; ++chunk) {
+			BufferFrame* frames = segment.chunks[chunk].load(std::memory_order_acquire);
+			if (frames == nullptr)
+				continue;
+
+			for (uint64_t i = 0; i < PAGE_MAPPING_CHUNK; ++i) {
+				BufferFrame& frame = frames[i];
+				if (!frame.isDirty())
+					continue;
+
+				frame.lock(false);
+				msync(frame.getData(), segment.pageSize, MS_SYNC);
+				if (frame.setClean()) {
+					written++;
+					if (bytes != nullptr)
+						*bytes += segment.pageSize;
+				}
+				frame.unlock();
+			}
+		}
+
+		return written;
+	}
+
+}
@@ -0,0 +1,157 @@
+//
+//  PageMapping.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "utils/Mutex.h"
+#include "common/IDs.h"
+#include "BufferFrame.h"
+#include "SegmentFiles.h"
+
+#define PAGE_MAPPING_PAGES (uint64_t(1) << 18)
+#define PAGE_MAPPING_CHUNK 1024
+#define PAGE_MAPPING_SEGMENTS (uint64_t(1) << 16)
+#define PAGE_MAPPING_GROWTH 64
+
+namespace lsql {
+
+	/**
+	 * Maps the files of all segments into memory for a buffer manager in
+	 * mapped mode.
+	 *
+	 * For each segment, a large virtual range is reserved with a shared file
+	 * mapping, so that the operating system loads pages on first access and
+	 * writes them back on its own. The frame descriptor of a page is found by
+	 * pointer arithmetic: descriptors are allocated in chunks of
+	 * @c PAGE_MAPPING_CHUNK pages and live for the lifetime of the mapping.
+	 * Their data pointers point into the mapping.
+	 *
+	 * Pages have the size registered for their segment in the @c SegmentFiles
+	 * when the segment is mapped.
+	 *
+	 * Accessing a file mapping past the end of the file is an error. The
+	 * range beyond the end is therefore covered by an anonymous read-only
+	 * mapping, so such pages read as zeros without touching the file. Files
+	 * grow in steps of @c PAGE_MAPPING_GROWTH pages only when a page beyond
+	 * their end is requested for writing, which maps the file over the new
+	 * range.
+	 */
+	class PageMapping {
+
+		struct Segment {
+			char* base;
+			size_t pageSize;
+			File<void>* file;
+			std::atomic<uint64_t> filePages;
+			std::atomic<BufferFrame*>* chunks;
+			Mutex growMutex;
+		};
+
+		SegmentFiles& files;
+		uint64_t pages;
+		std::atomic<Segment*>* segments;
+		Mutex mapMutex;
+
+	public:
+
+		/**
+		 * Creates a mapping for the given files. Segments are mapped on first
+		 * access.
+		 *
+		 * @param files The files of all segments.
+		 * @param pages The maximum number of pages per segment.
+		 */
+		PageMapping(SegmentFiles& files, uint64_t pages);
+
+		/** Prevent the copy constructor. */
+		PageMapping(const PageMapping& other) = delete;
+
+		/** Prevent copy assignments. */
+		PageMapping& operator=(const PageMapping& other) = delete;
+
+		/**
+		 * Destroys all descriptors and unmaps all segments. Dirty pages
+		 * should be synchronized before.
+		 */
+		~PageMapping();
+
+		/**
+		 * Returns the descriptor of the given page, mapping its segment if
+		 * necessary. The page is not fixed.
+		 *
+		 * @param id       The id of the page.
+		 * @param writable Whether the page might be modified. This extends
+		 *                 the file to contain the page.
+		 */
+		BufferFrame* getFrame(const PID& id, bool writable);
+
+		/**
+		 * Asks the operating system to load the given pages in the background.
+		 */
+		void prefetch(const PID& first, uint32_t count);
+
+		/**
+		 * Drops the page of the frame from memory. A dirty page is kept in
+		 * the page cache of the operating system until it is written back, so
+		 * this never loses data.
+		 */
+		void release(BufferFrame* frame);
+
+		/**
+		 * Writes all dirty pages of one or all segments to disc and marks
+		 * them clean. Each page is latched shared while it is written.
+		 *
+		 * @param all     Whether to write all segments.
+		 * @param segment The segment to write, unless @c all is set.
+		 * @param bytes   Optionally receives the number of bytes written.
+		 *
+		 * @return The number of pages written.
+		 */
+		uint64_t sync(bool all, uint16_t segment, uint64_t* bytes = nullptr);
+
+		/**
+		 * Returns whether the given segment has been mapped. The page size
+		 * of a mapped segment cannot change anymore.
+		 */
+		bool isMapped(uint16_t segment);
+
+	private:
+
+		/**
+		 * Returns the mapping of the given segment, creating it if necessary.
+		 */
+		Segment& getSegment(uint16_t segment);
+
+		/**
+		 * Creates the descriptors of one chunk of a segment, unless another
+		 * thread did so in the meantime.
+		 */
+		BufferFrame* createChunk(Segment& segment, uint16_t id, uint64_t chunk);
+
+		/**
+		 * Grows the file of the segment to contain the given page.
+		 */
+		void extend(Segment& segment, uint32_t page);
+
+		/**
+		 * Maps the file of the segment over the given range of pages, which
+		 * must be contained in the file.
+		 */
+		void mapFile(Segment& segment, uint64_t first, uint64_t end);
+
+		/**
+		 * Writes the dirty pages of one segment. See @c sync.
+		 */
+		uint64_t syncSegment(Segment& segment, uint64_t* bytes);
+
+	};
+
+}
@@ -0,0 +1,152 @@
+//
+//  PageTable.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+
+#include "PageTable.h"
+
+namespace lsql {
+
+	PageTable::Partition::Partition()
+	: size(0), mask(2 * PAGE_TABLE_PARTITION_SIZE - 1), entries(new Entry[mask + 1]()) {
+	}
+
+	PageTable::Partition::~Partition() {
+		delete[] entries;
+	}
+
+	bool PageTable::Partition::lock(bool exclusive) {
+		return latch.lock(exclusive);
+	}
+
+	bool PageTable::Partition::unlock() {
+		return latch.unlock();
+	}
+
+	uint32_t PageTable::Partition::getSize() const {
+		return size;
+	}
+
+	uint64_t PageTable::Partition::getCapacity() const {
+		return mask + 1;
+	}
+
+	BufferFrame* PageTable::Partition::getFrame(uint64_t index) const {
+		return entries[index].frame;
+	}
+
+	BufferFrame* PageTable::Partition::find(const PID& id) const {
+		uint64_t key = getKey(id);
+		for (uint64_t i = getHome(key); entries[i].frame != nullptr; i = (i + 1) & mask) {
+			if (entries[i].key == key)
+				return entries[i].frame;
+		}
+
+		return nullptr;
+	}
+
+	void PageTable::Partition::insert(BufferFrame* frame) {
+		if (2 * (size + 1) > getCapacity())
+			grow();
+
+		uint64_t key = getKey(frame->getId());
+		uint64_t i = getHome(key);
+		while (entries[i].frame != nullptr) {
+			assert(entries[i].key != key);
+			i = (i + 1) & mask;
+		}
+
+		entries[i].key = key;
+		entries[i].frame = frame;
+		size++;
+	}
+
+	bool PageTable::Partition::remove(BufferFrame* frame) {
+		uint64_t i = getHome(getKey(frame->getId()));
+		while (entries[i].frame != frame) {
+			if (entries[i].frame == nullptr)
+				return false;
+			i = (i + 1) & mask;
+		}
+
+		entries[i].frame = nullptr;
+		size--;
+
+		// Move following entries into the gap, unless their probe sequence
+		// starts after it. Otherwise, lookups would stop at the gap.
+		for (uint64_t j = (i + 1) & mask; entries[j].frame != nullptr; j = (j + 1) & mask) {
+			uint64_t distance = (j - getHome(entries[j].key)) & mask;
+			if (distance < ((j - i) & mask))
+				continue;
+
+			entries[i] = entries[j];
+			entries[j].frame = nullptr;
+			i = j;
+		}
+
+		return true;
+	}
+
+	uint64_t PageTable::Partition::getHome(uint64_t key) const {
+		return hash(key) & mask;
+	}
+
+	void PageTable::Partition::grow() {
+		Entry* old = entries;
+		uint64_t capacity = getCapacity();
+
+		mask = 2 * capacity - 1;
+		entries = new Entry[mask + 1]();
+		size = 0;
+
+		for (uint64_t i = 0; i < capacity; ++i) {
+			if (old[i].frame != nullptr)
+				insert(old[i].frame);
+		}
+
+		delete[] old;
+	}
+
+	PageTable::PageTable(uint64_t size) : partitionCount(1) {
+		while (partitionCount * PAGE_TABLE_PARTITION_SIZE < size)
+			partitionCount *= 2;
+
+		partitions = new Partition[partitionCount];
+	}
+
+	PageTable::~PageTable() {
+		delete[] partitions;
+	}
+
+	uint64_t PageTable::hash(uint64_t id) {
+		id ^= id >> 33;
+		id *= 0xff51afd7ed558ccdULL;
+		id ^= id >> 33;
+		id *= 0xc4ceb9fe1a85ec53ULL;
+		id ^= id >> 33;
+		return id;
+	}
+
+	uint64_t PageTable::getKey(const PID& id) {
+		return PID(id.segment(), id.page()).id;
+	}
+
+	uint64_t PageTable::getPartitionCount() const {
+		return partitionCount;
+	}
+
+	PageTable::Partition& PageTable::getPartition(const PID& id) const {
+		// The low bits select the entry within the partition
+		return partitions[(hash(getKey(id)) >> 32) & (partitionCount - 1)];
+	}
+
+	PageTable::Partition& PageTable::getPartitionAt(uint64_t index) const {
+		return partitions[index];
+	}
+
+}
@@ -0,0 +1,189 @@
+//
+//  PageTable.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "utils/Latch.h"
+#include "common/IDs.h"
+#include "BufferFrame.h"
+
+#define PAGE_TABLE_PARTITION_SIZE 16
+
+namespace lsql {
+
+	/**
+	 * Maps page ids to the frames of a buffer manager.
+	 *
+	 * The table is split into partitions, each of which is latched on its own.
+	 * A partition is an open addressing hash table with linear probing, which
+	 * stores the full page id next to the frame pointer, so lookups only touch
+	 * a few adjacent cache lines and never dereference foreign frames.
+	 *
+	 * Both the partition and the position within it are derived from a strong
+	 * 64-bit mixing hash of the page id, so pages with the same number in
+	 * different segments are spread evenly. A partition doubles its capacity
+	 * once it is half full. Entries are removed by shifting the following
+	 * entries of the probe sequence back, so no tombstones are needed.
+	 */
+	class PageTable {
+
+	public:
+
+		/**
+		 * A latched part of the page table. All methods except @c lock and
+		 * @c unlock require the caller to hold the latch, in exclusive mode
+		 * for modifications.
+		 */
+		class Partition {
+
+			struct Entry {
+				uint64_t key;
+				BufferFrame* frame;
+			};
+
+			Latch latch;
+			uint32_t size;
+			uint64_t mask;
+			Entry* entries;
+
+		public:
+
+			/**
+			 * Creates an empty partition.
+			 */
+			Partition();
+
+			/** Prevent the copy constructor. */
+			Partition(const Partition& other) = delete;
+
+			/** Prevent copy assignments. */
+			Partition& operator=(const Partition& other) = delete;
+
+			/**
+			 * Releases the entries, but not the frames.
+			 */
+			~Partition();
+
+			/**
+			 * Latches the partition. See @c Latch::lock.
+			 */
+			bool lock(bool exclusive);
+
+			/**
+			 * Releases the latch on the partition.
+			 */
+			bool unlock();
+
+			/**
+			 * Returns the number of frames in this partition.
+			 */
+			uint32_t getSize() const;
+
+			/**
+			 * Returns the number of entries in this partition, including
+			 * empty ones.
+			 */
+			uint64_t getCapacity() const;
+
+			/**
+			 * Returns the frame stored in the given entry, or @c nullptr if
+			 * the entry is empty. This is used to iterate over all frames.
+			 *
+			 * @param index An entry index below @c getCapacity.
+			 */
+			BufferFrame* getFrame(uint64_t index) const;
+
+			/**
+			 * Returns the frame containing the given page.
+			 *
+			 * @return A pointer to the page frame, if found; otherwise @c nullptr.
+			 */
+			BufferFrame* find(const PID& id) const;
+
+			/**
+			 * Inserts a frame under its current page id, which must not be
+			 * contained in the table yet.
+			 */
+			void insert(BufferFrame* frame);
+
+			/**
+			 * Removes a frame under its current page id.
+			 *
+			 * @return True if the frame has been removed; otherwise false.
+			 */
+			bool remove(BufferFrame* frame);
+
+		private:
+
+			/**
+			 * Returns the index of the first entry of the probe sequence.
+			 */
+			uint64_t getHome(uint64_t key) const;
+
+			/**
+			 * Doubles the capacity and inserts all entries again.
+			 */
+			void grow();
+
+		};
+
+	private:
+
+		Partition* partitions;
+		uint64_t partitionCount;
+
+	public:
+
+		/**
+		 * Creates an empty page table for the given number of frames.
+		 *
+		 * @param size The maximum number of frames in the table.
+		 */
+		explicit PageTable(uint64_t size);
+
+		/** Prevent the copy constructor. */
+		PageTable(const PageTable& other) = delete;
+
+		/** Prevent copy assignments. */
+		PageTable& operator=(const PageTable& other) = delete;
+
+		~PageTable();
+
+		/**
+		 * Mixes all bits of the page id into a 64-bit hash value, using the
+		 * finalizer of MurmurHash3.
+		 */
+		static uint64_t hash(uint64_t id);
+
+		/**
+		 * Returns the key of a page in the table. Like the comparison of
+		 * PIDs, it ignores the tuple bits of TIDs passed as page ids.
+		 */
+		static uint64_t getKey(const PID& id);
+
+		/**
+		 * Returns the number of partitions.
+		 */
+		uint64_t getPartitionCount() const;
+
+		/**
+		 * Returns the partition responsible for the given page.
+		 */
+		Partition& getPartition(const PID& id) const;
+
+		/**
+		 * Returns the partition at the given index. This is used to iterate
+		 * over all partitions.
+		 */
+		Partition& getPartitionAt(uint64_t index) const;
+
+	};
+
+}
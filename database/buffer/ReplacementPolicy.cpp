@@ -0,0 +1,61 @@
+//
+//  ReplacementPolicy.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "ReplacementPolicy.h"
+
+namespace lsql {
+
+	BufferFrame* ReplacementPolicy::evictLast(FrameQueue& queue, FrameEvictor& evictor) {
+		BufferFrame* frame = queue.getLast();
+		for (; frame != nullptr; frame = frame->queuePrev) {
+			if (frame->fixCount > 0)
+				continue;
+
+			// The evictor checks again, as the frame might have been fixed,
+			// and skips dirty frames, which are written after the latch
+			// has been released
+			if (evictor.evictFrame(frame)) {
+				queue.remove(frame);
+				frame->queue = QUEUE_NONE;
+				break;
+			}
+		}
+
+		return frame;
+	}
+
+	bool ReplacementPolicy::evictFrame(FrameQueue& queue, BufferFrame* frame, const PID& id, FrameEvictor& evictor) {
+		// A tracked frame cannot be assigned to another page
+		if (frame->getId() != id || frame->fixCount > 0 || !evictor.evictFrame(frame))
+			return false;
+
+		queue.remove(frame);
+		frame->queue = QUEUE_NONE;
+		return true;
+	}
+
+	void ReplacementPolicy::collectLast(FrameQueue& queue, std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget) {
+		// Frames cannot be paged out while the queue is latched, so they
+		// can be fixed without latching their slot.
+		BufferFrame* frame = queue.getLast();
+		for (uint64_t i = 0; frame != nullptr && i < window && frames.size() < budget; ++i) {
+			if (frame->isDirty() && frame->fixCount == 0) {
+				frame->fixCount++;
+				frames.push_back(frame);
+			}
+
+			frame = frame->queuePrev;
+		}
+	}
+
+	void ReplacementPolicy::collectFirst(FrameQueue& queue, std::vector<PID>& pages) {
+		for (BufferFrame* frame = queue.getFirst(); frame != nullptr; frame = frame->queueNext)
+			pages.push_back(frame->getId());
+	}
+
+}
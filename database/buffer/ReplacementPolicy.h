@@ -0,0 +1,174 @@
+//
+//  ReplacementPolicy.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/ConcurrentList.h"
+#include "common/IDs.h"
+#include "BufferFrame.h"
+
+namespace lsql {
+
+	/**
+	 * The page replacement algorithms available to a @c BufferManager.
+	 */
+	enum ReplacementType {
+		REPLACEMENT_2Q = 0,
+		REPLACEMENT_CLOCK,
+		REPLACEMENT_LRU_K,
+		REPLACEMENT_ARC
+	};
+
+	/**
+	 * Implementation of the ConcurrentList AccessPolicy for frame queues.
+	 */
+	struct FrameQueuePolicy {
+		BufferFrame*& next(BufferFrame* frame) const { return frame->queueNext; }
+		BufferFrame*& prev(BufferFrame* frame) const { return frame->queuePrev; }
+	};
+
+	/**
+	 * Type definition for threadsafe queues of buffer frames.
+	 */
+	typedef ConcurrentList<BufferFrame, FrameQueuePolicy> FrameQueue;
+
+	/**
+	 * Removes frames chosen by a replacement policy from the buffer manager.
+	 */
+	class FrameEvictor {
+
+	public:
+
+		virtual ~FrameEvictor() {}
+
+		/**
+		 * Removes the frame from the page table, unless it is fixed or dirty.
+		 * The frame must be tracked by the calling policy, which holds its
+		 * latch during this call, so no I/O is done here. Dirty frames are
+		 * written by the buffer manager once the policy has been released.
+		 *
+		 * @param frame The frame to remove.
+		 * @return True if the frame has been removed; otherwise false.
+		 */
+		virtual bool evictFrame(BufferFrame* frame) = 0;
+
+	};
+
+	/**
+	 * Decides which frames are paged out by a @c BufferManager.
+	 *
+	 * A policy tracks all frames which are in the page table. It receives all
+	 * accesses to these frames and chooses a victim, if the buffer manager
+	 * runs out of free frames. Policies synchronize all methods internally,
+	 * and always acquire their latches before the latch of a page table slot.
+	 *
+	 * Frames are linked into the queues of a policy via @c queueNext and
+	 * @c queuePrev. The @c queue field is set, while a frame is tracked.
+	 */
+	class ReplacementPolicy {
+
+	public:
+
+		virtual ~ReplacementPolicy() {}
+
+		/**
+		 * Returns a short name for this policy.
+		 */
+		virtual const char* getName() const = 0;
+
+		/**
+		 * Starts tracking a frame which has just been inserted into the page
+		 * table. The frame is fixed by the caller.
+		 */
+		virtual void insert(BufferFrame* frame) = 0;
+
+		/**
+		 * Registers another access to a frame. The frame is fixed by the
+		 * caller, but might not be tracked yet.
+		 */
+		virtual void access(BufferFrame* frame) = 0;
+
+		/**
+		 * Chooses an unfixed, clean frame and removes it from the buffer
+		 * manager using the given evictor. The frame is no longer tracked
+		 * afterwards.
+		 *
+		 * @param evictor The evictor of the buffer manager.
+		 * @return The removed frame, or @c nullptr if all frames are fixed or
+		 *         dirty.
+		 */
+		virtual BufferFrame* evict(FrameEvictor& evictor) = 0;
+
+		/**
+		 * Removes the frame of the given page like @c evict, but only if it
+		 * has not been accessed again since it was loaded. This is used to
+		 * recycle frames of sequential scans.
+		 *
+		 * @param frame   The frame containing the page.
+		 * @param id      The page expected in this frame.
+		 * @param evictor The evictor of the buffer manager.
+		 *
+		 * @return True if the frame has been removed; otherwise false.
+		 */
+		virtual bool discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor) = 0;
+
+		/**
+		 * Fixes dirty frames which are likely to be paged out soon, so that
+		 * they can be written in the background.
+		 *
+		 * @param frames Receives the fixed frames.
+		 * @param window The number of frames to inspect per queue.
+		 * @param budget The maximum number of frames to return.
+		 */
+		virtual void collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget) = 0;
+
+		/**
+		 * Lists the pages of all tracked frames, hottest first. This is used
+		 * to warm up the buffer after a restart.
+		 *
+		 * @param pages Receives the page ids.
+		 */
+		virtual void collectPages(std::vector<PID>& pages) = 0;
+
+	protected:
+
+		/**
+		 * Evicts the last frame of the queue accepted by the evictor. The
+		 * queue has to be latched exclusively by the caller.
+		 *
+		 * @return The removed frame, or @c nullptr if all frames are fixed or
+		 *         dirty.
+		 */
+		static BufferFrame* evictLast(FrameQueue& queue, FrameEvictor& evictor);
+
+		/**
+		 * Removes the frame from the queue like @c evictLast, if it is not
+		 * fixed and still contains the given page.
+		 *
+		 * @return True if the frame has been removed; otherwise false.
+		 */
+		static bool evictFrame(FrameQueue& queue, BufferFrame* frame, const PID& id, FrameEvictor& evictor);
+
+		/**
+		 * Fixes dirty frames at the end of the queue, which has to be latched
+		 * by the caller. See @c collectDirty.
+		 */
+		static void collectLast(FrameQueue& queue, std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget);
+
+		/**
+		 * Lists the pages of all frames in the queue from front to back. The
+		 * queue has to be latched by the caller. See @c collectPages.
+		 */
+		static void collectFirst(FrameQueue& queue, std::vector<PID>& pages);
+
+	};
+
+}
@@ -0,0 +1,61 @@
+//
+//  SegmentFiles.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <string>
+
+#include "BufferFrame.h"
+#include "SegmentFiles.h"
+
+namespace lsql {
+
+	SegmentFiles::SegmentFiles(bool direct) : direct(direct) {
+	}
+
+	SegmentFiles::~SegmentFiles() {
+		for (File<void>* file : files)
+			delete file;
+	}
+
+	File<void>& SegmentFiles::get(uint16_t segment) {
+		l.lock(false);
+		if (segment < files.size() && files[segment] != nullptr) {
+			File<void>& file = *files[segment];
+			l.unlock();
+			return file;
+		}
+		l.unlock();
+
+		// Open the file, unless another thread did so in the meantime
+		l.lock(true);
+		if (segment >= files.size())
+			files.resize(segment + 1, nullptr);
+		if (files[segment] == nullptr)
+			files[segment] = new File<void>(std::to_string(segment), true, direct);
+
+		File<void>& file = *files[segment];
+		l.unlock();
+		return file;
+	}
+
+	size_t SegmentFiles::getPageSize(uint16_t segment) {
+		l.lock(false);
+		size_t pageSize = (segment < pageSizes.size()) ? pageSizes[segment] : BufferFrame::SIZE;
+		l.unlock();
+
+		return pageSize;
+	}
+
+	void SegmentFiles::setPageSize(uint16_t segment, size_t pageSize) {
+		l.lock(true);
+		if (segment >= pageSizes.size())
+			pageSizes.resize(segment + 1, BufferFrame::SIZE);
+		pageSizes[segment] = pageSize;
+		l.unlock();
+	}
+
+}
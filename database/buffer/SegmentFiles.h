@@ -0,0 +1,87 @@
+//
+//  SegmentFiles.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "utils/File.h"
+#include "utils/Lock.h"
+
+namespace lsql {
+
+	/**
+	 * Keeps the files of all segments open for the lifetime of a buffer manager.
+	 *
+	 * Each segment is stored in a file named after its identifier. The file is
+	 * opened on first access and handed to all frames of the segment, so that
+	 * loading or saving a page only requires a single read or write call.
+	 *
+	 * The registry also records the page size of each segment, which
+	 * determines the offsets of its pages within the file.
+	 */
+	class SegmentFiles {
+
+		Lock l;
+		std::vector<File<void>*> files;
+		std::vector<size_t> pageSizes;
+		bool direct;
+
+	public:
+
+		/**
+		 * Creates an empty registry. No files are opened until requested.
+		 *
+		 * @param direct Whether to open all files for direct I/O, so that
+		 *               pages are not cached by the operating system, too.
+		 */
+		SegmentFiles(bool direct = false);
+
+		/** Prevent the copy constructor. */
+		SegmentFiles(const SegmentFiles& other) = delete;
+
+		/** Prevent copy assignments. */
+		SegmentFiles& operator=(const SegmentFiles& other) = delete;
+
+		/**
+		 * Closes all open segment files.
+		 */
+		~SegmentFiles();
+
+		/**
+		 * Returns the file of the specified segment. If the file has not been
+		 * opened yet, it is opened in write mode and created if necessary.
+		 *
+		 * @param segment The segment identifier.
+		 * @return A reference to the open file.
+		 */
+		File<void>& get(uint16_t segment);
+
+		/**
+		 * Returns the size of all pages in the specified segment. Unless set
+		 * otherwise, this is @c BufferFrame::SIZE.
+		 *
+		 * @param segment The segment identifier.
+		 * @return The page size in bytes.
+		 */
+		size_t getPageSize(uint16_t segment);
+
+		/**
+		 * Sets the size of all pages in the specified segment. The page size
+		 * must not change while pages of the segment are in memory.
+		 *
+		 * @param segment  The segment identifier.
+		 * @param pageSize The page size in bytes.
+		 */
+		void setPageSize(uint16_t segment, size_t pageSize);
+
+	};
+
+}
@@ -0,0 +1,116 @@
+//
+//  TwoQueuePolicy.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "TwoQueuePolicy.h"
+
+namespace lsql {
+
+	TwoQueuePolicy::TwoQueuePolicy(uint64_t size, double threshold)
+	: threshold(uint64_t(threshold * size)) {
+	}
+
+	const char* TwoQueuePolicy::getName() const {
+		return "2Q";
+	}
+
+	void TwoQueuePolicy::insert(BufferFrame* frame) {
+		queueA1.lock(true);
+		frame->queue = QUEUE_A1;
+		queueA1.prepend(frame);
+		queueA1.unlock();
+	}
+
+	void TwoQueuePolicy::access(BufferFrame* frame) {
+		// Hits only mark the frame, it is promoted when it reaches the end of
+		// its queue. Avoid writing to shared cache lines of hot frames.
+		if (!frame->referenced.load(std::memory_order_relaxed))
+			frame->referenced.store(true, std::memory_order_relaxed);
+	}
+
+	BufferFrame* TwoQueuePolicy::evict(FrameEvictor& evictor) {
+		BufferFrame* frame;
+
+		if (queueA1.getSize() > threshold) {
+			frame = evictFrom(queueA1, evictor);
+			if (frame == nullptr)
+				frame = evictFrom(queueAm, evictor);
+		} else {
+			frame = evictFrom(queueAm, evictor);
+			if (frame == nullptr)
+				frame = evictFrom(queueA1, evictor);
+		}
+
+		return frame;
+	}
+
+	bool TwoQueuePolicy::discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor) {
+		queueA1.lock(true);
+		bool removed = frame->queue == QUEUE_A1 && !frame->referenced && evictFrame(queueA1, frame, id, evictor);
+		queueA1.unlock();
+
+		return removed;
+	}
+
+	void TwoQueuePolicy::collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget) {
+		// Flush queueA1 first, as it is usually paged out first
+		queueA1.lock(false);
+		collectLast(queueA1, frames, window, budget);
+		queueA1.unlock();
+
+		queueAm.lock(false);
+		collectLast(queueAm, frames, window, budget);
+		queueAm.unlock();
+	}
+
+	void TwoQueuePolicy::collectPages(std::vector<PID>& pages) {
+		queueAm.lock(false);
+		collectFirst(queueAm, pages);
+		queueAm.unlock();
+
+		queueA1.lock(false);
+		collectFirst(queueA1, pages);
+		queueA1.unlock();
+	}
+
+	BufferFrame* TwoQueuePolicy::evictFrom(FrameQueue& queue, FrameEvictor& evictor) {
+		BufferFrame* victim = nullptr;
+
+		queueA1.lock(true);
+		queueAm.lock(true);
+
+		// Referenced frames are moved to the front of queueAm and lose their
+		// reference bit. Like a clock hand, the scan wraps around at the front
+		// of the queue, so a frame is inspected at most twice. The evictor
+		// skips dirty frames, so no I/O is done while the queues are latched.
+		BufferFrame* frame = queue.getLast();
+		for (uint64_t steps = 2 * queue.getSize(); frame != nullptr && steps > 0; --steps) {
+			BufferFrame* prev = frame->queuePrev;
+
+			if (frame->referenced) {
+				frame->referenced = false;
+				queue.remove(frame);
+				frame->queue = QUEUE_AM;
+				queueAm.prepend(frame);
+			} else if (frame->fixCount == 0 && evictor.evictFrame(frame)) {
+				// The evictor checks again, as the frame might have been fixed
+				queue.remove(frame);
+				frame->queue = QUEUE_NONE;
+				victim = frame;
+				break;
+			}
+
+			frame = (prev != nullptr) ? prev : queue.getLast();
+		}
+
+		queueAm.unlock();
+		queueA1.unlock();
+
+		return victim;
+	}
+
+}
@@ -0,0 +1,62 @@
+//
+//  TwoQueuePolicy.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include "ReplacementPolicy.h"
+
+namespace lsql {
+
+	/**
+	 * Simplified 2Q page replacement.
+	 *
+	 * New frames are inserted into the FIFO queue A1. Once accessed again, a
+	 * frame moves to the LRU queue Am. Frames are paged out from A1, as long
+	 * as it holds more than the given share of all frames; otherwise from Am.
+	 *
+	 * To keep page hits free of latches, an access only sets the reference
+	 * bit of the frame. Frames are reordered lazily during eviction: a
+	 * referenced frame at the end of either queue moves to the front of Am
+	 * instead of being paged out.
+	 */
+	class TwoQueuePolicy : public ReplacementPolicy {
+
+		uint64_t threshold;
+		FrameQueue queueA1;
+		FrameQueue queueAm;
+
+	public:
+
+		/**
+		 * Creates a new policy.
+		 *
+		 * @param size      The number of frames in the buffer manager.
+		 * @param threshold The share of frames in A1 before Am is preferred.
+		 */
+		TwoQueuePolicy(uint64_t size, double threshold);
+
+		const char* getName() const;
+		void insert(BufferFrame* frame);
+		void access(BufferFrame* frame);
+		BufferFrame* evict(FrameEvictor& evictor);
+		bool discard(BufferFrame* frame, const PID& id, FrameEvictor& evictor);
+		void collectDirty(std::vector<BufferFrame*>& frames, uint64_t window, uint64_t budget);
+		void collectPages(std::vector<PID>& pages);
+
+	private:
+
+		/**
+		 * Evicts the last unfixed and unreferenced frame of the given queue,
+		 * promoting referenced frames on the way. Dirty frames are left for
+		 * the buffer manager to write once both queues are released.
+		 */
+		BufferFrame* evictFrom(FrameQueue& queue, FrameEvictor& evictor);
+
+	};
+
+}
@@ -19,10 +19,10 @@ namespace lsql {
 
 	template<class Key, class Comparator>
 	BTree<Key, Comparator>::BTree(BufferManager& bufferManager, uint16_t segmentId, uint32_t pageCount)
-	: size(0), root(NULL_PID), Segment(bufferManager, segmentId, pageCount) {
-		if (root == NULL_PID) {
-			root = addPage();
-			BufferFrame& rootFrame = fixPage(root, true);
+	: Segment(bufferManager, segmentId, pageCount), size(0), root(NULL_PID.id) {
+		if (PID(root) == NULL_PID) {
+			root = addPage().id;
+			BufferFrame& rootFrame = fixPage(PID(root), true);
 			Node(rootFrame, NodeType::Leaf);
 			unfixPage(rootFrame, true);
 		}
@@ -30,7 +30,7 @@ namespace lsql {
 
 	template<class Key, class Comparator>
 	TID BTree<Key, Comparator>::lookup(const Key& key) {
-		BufferFrame& frame = findLeafFrame(key);
+		BufferFrame& frame = findLeafFrameOptimistic(key);
 		Node leaf(frame);
 		assert(leaf.getType() == NodeType::Leaf);
 
@@ -47,12 +47,21 @@ namespace lsql {
 
 	template<class Key, class Comparator>
 	bool BTree<Key, Comparator>::insert(const Key& key, const TID& tid) {
-		BufferFrame& frame = findLeafFrame(key);
-		Node leaf(frame);
-		assert(leaf.getType() == NodeType::Leaf);
+		BufferFrame* frame = &findLeafFrame(key);
+		bool success = Node(*frame).insert(key, tid);
+		bool dirty = success;
+
+		// Split full nodes on the way down and try again
+		if (!success && Node(*frame).isFull()) {
+			unfixPage(*frame, false);
+			frame = &findLeafFrame(key, true);
+			success = Node(*frame).insert(key, tid);
+			dirty = true;
+		}
 
-		bool success = leaf.insert(key, tid);
-		unfixPage(frame, success);
+		unfixPage(*frame, dirty);
+		if (success)
+			size++;
 
 		return success;
 	}
@@ -65,6 +74,9 @@ namespace lsql {
 
 		bool success = leaf.remove(key);
 		unfixPage(frame, success);
+		if (success)
+			size--;
+
 		return success;
 	}
 
@@ -90,60 +102,134 @@ namespace lsql {
 		std::ostream& os = std::cout;
 		os << "digraph myBTree {\n node [shape=record]; \n";
 
-		visualizeRecurse(root, std::cout);
+		visualizeRecurse(PID(root), std::cout);
 
 		os << " }";
 	}
 
 	template<class Key, class Comparator>
 	BufferFrame& BTree<Key, Comparator>::findLeafFrame(const Key& key, bool split) {
-		Key parentKey;
 		BufferFrame* parentFrame = nullptr;
-		BufferFrame* currentFrame = &fixPage(root, split);
+		bool parentDirty = false;
+
+		// The root might have been split while waiting for its latch
+		BufferFrame* currentFrame;
+		while (true) {
+			PID rootPID(root);
+			currentFrame = split ? &fixPage(rootPID, true) : &fixPageUpdate(rootPID);
+			if (PID(root) == rootPID)
+				break;
+			unfixPage(*currentFrame, false);
+		}
 
 		while (true) {
 			Node currentNode(*currentFrame);
+			assert(currentNode.isValid());
+			bool currentDirty = false;
 
 			// Check if the node has to be split up
-			bool hasSplit = false;
 			if (split && currentNode.isFull()) {
 
 				// Create a new node and split up the current node's contents
 				PID newPID = addPage();
 				BufferFrame* newFrame = &fixPage(newPID, true);
 				Node newNode(*newFrame, currentNode.getType());
-				const Key& splitKey = currentNode.splitInto(newNode);
+				Key splitKey = currentNode.splitInto(newNode);
 
-				// Insert the new node into the parent.
+				// Insert the new node into the parent. Readers check the root
+				// again after fixing it, so they do not descend the old one.
 				if (parentFrame == nullptr) {
 					parentFrame = &fixPage(addPage(), true);
-					root = parentFrame->getId();
-					Node(*parentFrame).insert(splitKey, newPID.id);
+					Node(*parentFrame, NodeType::Inner).insertSplit(splitKey, currentFrame->getId(), newPID);
+					root = parentFrame->getId().id;
 				} else {
-					Node parentNode(*parentFrame);
-					parentNode.switchKey(parentKey, splitKey);
-					parentNode.insert(parentKey, newPID.id);
+					Node(*parentFrame).insertSplit(splitKey, currentFrame->getId(), newPID);
 				}
 
-				// Continue with the correct node
-				if (compare(key, splitKey) > 9)
+				// Continue with the node covering the key
+				if (compare(key, splitKey) > 0) {
+					unfixPage(*currentFrame, true);
+					currentFrame = newFrame;
 					currentNode = newNode;
+				} else {
+					unfixPage(*newFrame, true);
+				}
 
-				hasSplit = true;
+				parentDirty = true;
+				currentDirty = true;
 			}
 
 			// Release the parent node as it is no longer needed
 			if (parentFrame != nullptr)
-				unfixPage(*parentFrame, hasSplit);
+				unfixPage(*parentFrame, parentDirty);
 
 			// We might have found, what we are looking for
-			if (currentNode.getType() == NodeType::Leaf)
+			if (currentNode.getType() == NodeType::Leaf) {
+				if (!split)
+					upgradePage(*currentFrame);
 				return *currentFrame;
+			}
 
 			// Move down to the appropriate child node
 			parentFrame = currentFrame;
-			PID childPID = currentNode.lookup(key, true, &parentKey);
-			currentFrame = &fixPage(childPID, split);
+			parentDirty = currentDirty;
+			PID childPID = currentNode.lookup(key, true);
+			currentFrame = split ? &fixPage(childPID, true) : &fixPageUpdate(childPID);
+		}
+	}
+
+	template<class Key, class Comparator>
+	BufferFrame& BTree<Key, Comparator>::findLeafFrameOptimistic(const Key& key) {
+		while (true) {
+			uint64_t version;
+			PID rootPID(root);
+			BufferFrame* frame = &fixPageOptimistic(rootPID, version);
+
+			// The old root only covers part of the keys after a split
+			if (PID(root) != rootPID) {
+				unfixPageOptimistic(*frame);
+				continue;
+			}
+
+			while (true) {
+				Node node(*frame);
+
+				// Do not trust the header of a node modified concurrently. A
+				// valid version guarantees a consistent node.
+				if (!node.isValid()) {
+					bool changed = !validatePage(*frame, version);
+					assert(changed); (void) changed;
+					break;
+				}
+
+				// Lock the leaf, if it has not changed while reading its type
+				if (node.getType() == NodeType::Leaf) {
+					if (lockPage(*frame, version, false))
+						return *frame;
+					break;
+				}
+
+				// Do not follow child pointers read from a modified node
+				PID childPID = node.lookup(key, true);
+				if (!validatePage(*frame, version))
+					break;
+
+				uint64_t childVersion;
+				BufferFrame* childFrame = &fixPageOptimistic(childPID, childVersion);
+
+				// The parent might have been split while fixing the child
+				bool valid = validatePage(*frame, version);
+				unfixPageOptimistic(*frame);
+
+				frame = childFrame;
+				version = childVersion;
+
+				if (!valid)
+					break;
+			}
+
+			// Restart from the root
+			unfixPageOptimistic(*frame);
 		}
 	}
 
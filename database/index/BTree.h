@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "common/IDs.h"
@@ -31,8 +32,10 @@ namespace lsql {
 		/** Shortcut for BTree nodes. */
 		typedef BTreeNode<Key, Comparator> Node;
 
-		uint64_t size;
-		PID root;
+		std::atomic<uint64_t> size;
+
+		/** The id of the root node, which changes when the root is split. */
+		std::atomic<uint64_t> root;
 
 	public:
 
@@ -115,8 +118,10 @@ namespace lsql {
 		 * full nodes. To prevent race conditions and dead locks, lock coupling 
 		 * (latching) is used.
 		 *
-		 * The returned BufferFrame is locked by this method. If split is @c true,
-		 * an exclusive lock is used. See @c BufferFrame::lock for more information.
+		 * The returned BufferFrame is locked exclusively by this method. If split
+		 * is @c false, nodes are locked in update mode on the way down, so that
+		 * concurrent readers are not blocked, and only the leaf is upgraded.
+		 * See @c BufferFrame::lock for more information.
 		 *
 		 * @param key   A reference to the key that should be found.
 		 * @param split Whether to split nodes while traversing or not.
@@ -124,6 +129,20 @@ namespace lsql {
 		 */
 		BufferFrame& findLeafFrame(const Key& key, bool split = false);
 
+		/**
+		 * Finds the leaf where a key should be stored without locking inner
+		 * nodes.
+		 *
+		 * Inner nodes are read optimistically and validated against their
+		 * version afterwards. If any node on the path has been modified in the
+		 * meantime, the traversal restarts at the root. Only the leaf is locked
+		 * in shared mode.
+		 *
+		 * @param key A reference to the key that should be found.
+		 * @return    A reference to a fixed BufferFrame of the corresponding leaf.
+		 */
+		BufferFrame& findLeafFrameOptimistic(const Key& key);
+
 	};
 
 }
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include "BTreeNode.h"
@@ -23,14 +24,15 @@ namespace lsql {
 		if (type != None)
 			reset(type);
 
-		initialize(data);
+		initialize(data, frame.getSize());
 	}
 
 	template<typename Key, typename Comparator>
 	TID BTreeNode<Key, Comparator>::lookup(const Key& key, bool allowRight, Key* found) const {
 		size_t i = findPos(key);
 
-		if (i == header->count && !allowRight)
+		// Leaves only contain exact matches
+		if (!allowRight && (i == getCount() || compare(key, keys[i]) != 0))
 			return NULL_TID;
 
 		if (found != nullptr)
@@ -50,7 +52,7 @@ namespace lsql {
 		size_t pos = findPos(key);
 
 		// Do not allow duplicates
-		if (compare(keys[pos], key) == 0)
+		if (pos < header->count && compare(keys[pos], key) == 0)
 			return false;
 
 		// Insert the new entry and move everything else to the back
@@ -98,7 +100,20 @@ namespace lsql {
 			std::memcpy(other.values, values + n - o, o * sizeof(TID));
 		}
 
-		return keys[header->count - 1];
+		// The median key of inner nodes is moved up into the parent
+		return (header->type == NodeType::Inner) ? keys[c] : keys[c - 1];
+	}
+
+	template<typename Key, typename Comparator>
+	void BTreeNode<Key, Comparator>::insertSplit(const Key& key, const PID& left, const PID& right) {
+		assert(header->type == NodeType::Inner && header->count < n);
+
+		// The child covering the key is now split into two children
+		size_t pos = findPos(key);
+		moveEntries(pos, 1);
+		keys[pos] = key;
+		values[pos] = left;
+		values[pos + 1] = right;
 	}
 
 	template<typename Key, typename Comparator>
@@ -117,6 +132,12 @@ namespace lsql {
 		return header->count >= n;
 	}
 
+	template<typename Key, typename Comparator>
+	bool BTreeNode<Key, Comparator>::isValid() const {
+		NodeType type = header->type;
+		return (type == NodeType::Inner || type == NodeType::Leaf) && header->count <= n;
+	}
+
 	template<class Key, class Comparator>
 	std::vector<PID> BTreeNode<Key, Comparator>::visualize(std::ostream& dataOut) {
 
@@ -170,11 +191,12 @@ namespace lsql {
 	}
 
 	template<typename Key, typename Comparator>
-	void BTreeNode<Key, Comparator>::initialize(char* data) {
+	void BTreeNode<Key, Comparator>::initialize(char* data, size_t size) {
 		assert(data != nullptr);
-		assert(header->type != NodeType::None);
 
-		size_t size = BufferFrame::SIZE - sizeof(Header);
+		// Nodes read optimistically may be modified concurrently, so their
+		// type is not asserted here. See isValid.
+		size -= sizeof(Header);
 		if (header->type == NodeType::Inner)
 			size -= sizeof(TID);
 
@@ -195,17 +217,27 @@ namespace lsql {
 
 	template<typename Key, typename Comparator>
 	size_t BTreeNode<Key, Comparator>::findPos(const Key& key) const {
-		for (size_t pos = 0; pos < header->count; pos++)
+		size_t count = getCount();
+		for (size_t pos = 0; pos < count; pos++)
 			if (compare(key, keys[pos]) <= 0)
 				return pos;
 
-		return header->count;
+		return count;
+	}
+
+	template<typename Key, typename Comparator>
+	size_t BTreeNode<Key, Comparator>::getCount() const {
+		// Never read beyond the node, even if the header is being modified
+		return std::min<size_t>(header->count, n);
 	}
 
 	template<typename Key, typename Comparator>
 	void BTreeNode<Key, Comparator>::moveEntries(size_t offset, ssize_t distance) {
-		std::memmove(keys + offset + distance, keys + distance, header->count - offset * sizeof(Key));
-		std::memmove(values + offset + distance, values + distance, header->count - offset * sizeof(TID));
+		// Inner nodes have one more value, pointing to the right outer child
+		size_t valueCount = header->count + (header->type == NodeType::Inner ? 1 : 0);
+
+		std::memmove(keys + offset + distance, keys + offset, (header->count - offset) * sizeof(Key));
+		std::memmove(values + offset + distance, values + offset, (valueCount - offset) * sizeof(TID));
 		header->count += distance;
 	}
 
@@ -115,6 +115,17 @@ namespace lsql {
 		 */
 		void switchKey(const Key& oldKey, const Key& newKey);
 
+		/**
+		 * Registers a split child in this inner node. The child covering
+		 * @c key has been split into @c left, which keeps all entries up to
+		 * @c key, and @c right. The node must not be full.
+		 *
+		 * @param key   The split key returned by @c splitInto.
+		 * @param left  The child which has been split.
+		 * @param right The child which has received the upper half.
+		 */
+		void insertSplit(const Key& key, const PID& left, const PID& right);
+
 		/**
 		 * Returns whether a node is an inner or a leaf node.
 		 */
@@ -124,6 +135,12 @@ namespace lsql {
 		 * Determines whether this node has reached it's capacity or not.
 		 */
 		bool isFull() const;
+
+		/**
+		 * Checks the header of a node which has been read without a latch.
+		 * Entries of invalid nodes must not be followed.
+		 */
+		bool isValid() const;
 		
 		/**
 		 * Prints the content
@@ -140,8 +157,9 @@ namespace lsql {
 		 * Initializes this node. This eventually overwrites all node contents.
 		 *
 		 * @param data A pointer to the internal data of this node.
+		 * @param size The size of the page containing this node.
 		 */
-		void initialize(char* data);
+		void initialize(char* data, size_t size);
 
 		/**
 		 * Resets the node and deletes all data.
@@ -163,6 +181,11 @@ namespace lsql {
 		 */
 		size_t findPos(const Key& key) const;
 
+		/**
+		 * Returns the number of entries, bounded by the capacity of the node.
+		 */
+		size_t getCount() const;
+
 		/**
 		 * Moves all entries within this page to insert new ones or remove old ones.
 		 *
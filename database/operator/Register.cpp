@@ -64,6 +64,11 @@ namespace lsql {
 		return *this;
 	}
 
+	void Register::assign(const char* value, size_t length) {
+		assert(type == Type::Char);
+		data.c.assign(value, length);
+	}
+
 	std::ostream& operator<<(std::ostream& os, const Register& r) {
 		switch (r.type) {
 			case Type::Char:
@@ -94,6 +94,15 @@ namespace lsql {
 		 */
 		Register& operator=(const Integer& i);
 
+		/**
+		 * Assigns a Char value directly from raw data. The register must
+		 * already contain a Char, whose storage is reused.
+		 *
+		 * @param value  A pointer to the characters.
+		 * @param length The number of characters.
+		 */
+		void assign(const char* value, size_t length);
+
 		/**
 		 * Pipe operator for printing the values of the register object
 		 * to a stream.
@@ -31,14 +31,13 @@ namespace lsql {
 			}
 
 			if (tuples != page->end()) {
-				for (Register* rp : output)
-					delete rp;
-
-				output = buildRow(*tuples);
+				buildRow(*tuples, output);
 				++tuples;
 				return true;
 			}
 
+			tuples = SlottedPage::Iterator();
+			page = nullptr;
 			++pages;
 		}
 
@@ -60,37 +59,46 @@ namespace lsql {
 	void TableScanOperator::close() {
 		assert(isOpen);
 
+		tuples = SlottedPage::Iterator();
 		page = nullptr;
 		pages = segment.end();
 		isOpen = false;
+
+		for (Register* rp : output)
+			delete rp;
+		output.clear();
 	}
 
-	Row TableScanOperator::buildRow(const Record& record) const {
-		Row row(segment.attributes.size());
+	void TableScanOperator::buildRow(const RecordView& record, Row& row) const {
+		bool allocate = row.empty();
 		const char* data = record.getData();
 
-		for (auto& attribute : segment.attributes) {
-			Register* r;
+		for (size_t i = 0; i < segment.attributes.size(); ++i) {
+			switch (segment.attributes[i].type) {
+				case Type::Integer: {
+					Integer value = *reinterpret_cast<const Integer*>(data);
+					if (allocate)
+						row.push_back(new Register(value));
+					else
+						*row[i] = value;
 
-			switch (attribute.type) {
-				case Type::Integer:
-					r = new Register(*reinterpret_cast<const Integer*>(data));
 					data += INTEGER_LEN;
 					break;
+				}
 
 				case Type::Char:
-					r = new Register(Char(data, CHAR_LEN));
+					if (allocate)
+						row.push_back(new Register(Char(data, CHAR_LEN)));
+					else
+						row[i]->assign(data, CHAR_LEN);
+
 					data += CHAR_LEN;
 					break;
 
 				default:
 					assert(false);
 			}
-
-			row.push_back(r);
 		}
-
-		return row;
 	}
 
 }
\ No newline at end of file
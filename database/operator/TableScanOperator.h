@@ -9,6 +9,7 @@
 #pragma once
 
 #include "schema/Relation.h"
+#include "segment/RecordView.h"
 #include "segment/SlottedPage.h"
 #include "segment/SPSegment.h"
 #include "IOperator.h"
@@ -47,9 +48,14 @@ namespace lsql {
 	private:
 
 		/**
-		 * 
+		 * Decodes a record into the given row. The registers of the row are
+		 * reused if it has been built before, so only the first tuple of a
+		 * scan allocates.
+		 *
+		 * @param record A view of the record data.
+		 * @param row    The row to fill.
 		 */
-		Row buildRow(const Record& record) const;
+		void buildRow(const RecordView& record, Row& row) const;
 
 	};
 
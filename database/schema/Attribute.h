@@ -71,11 +71,13 @@ namespace lsql {
 			static Attribute apply(StreamType::const_iterator& begin,
 														 StreamType::const_iterator end,
 														 void* context = nullptr) {
-				return Attribute(
-					std::move(deserialize_helper<std::string>::apply(begin,end)),
-					std::move(deserialize_helper<Type>::apply(begin,end)),
-					deserialize_helper<uint32_t>::apply(begin,end),
-					deserialize_helper<bool>::apply(begin,end));
+				// Read fields in stream order; argument evaluation order is unspecified
+				std::string name = deserialize_helper<std::string>::apply(begin,end);
+				Type type = deserialize_helper<Type>::apply(begin,end);
+				uint32_t len = deserialize_helper<uint32_t>::apply(begin,end);
+				bool notNull = deserialize_helper<bool>::apply(begin,end);
+
+				return Attribute(std::move(name), std::move(type), len, notNull);
 			}
 
 		};
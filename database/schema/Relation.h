@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -17,6 +18,13 @@
 #include "segment/SPSegment.h"
 #include "Attribute.h"
 
+/** Catalog layout written before relations recorded their page size. */
+#define SCHEMA_VERSION_LEGACY 0
+/** Catalog layout storing the page size after the page count of relations. */
+#define SCHEMA_VERSION_PAGE_SIZE 1
+/** Catalog layout written by this build. */
+#define SCHEMA_VERSION SCHEMA_VERSION_PAGE_SIZE
+
 namespace lsql {
 
 	/**
@@ -32,18 +40,26 @@ namespace lsql {
 		Relation(BufferManager& bufferManager, uint16_t segmentId, uint32_t pageCount = 0)
 		: SPSegment(bufferManager, segmentId, pageCount) {}
 
-		/** Serialization constructor for relations. */
+		/**
+		 * Serialization constructor for relations. This also registers the
+		 * page size of the relation with the buffer manager, which must have
+		 * a frame pool for it.
+		 */
 		Relation(BufferManager& bufferManager, uint16_t segmentId, uint32_t pageCount,
-						 std::string&& name, std::vector<unsigned>&& primaryKey,
+						 uint32_t pageSize, std::string&& name, std::vector<unsigned>&& primaryKey,
 						 std::vector<Attribute>&& attributes)
 		: Relation(bufferManager, segmentId, pageCount) {
+			bool supported = bufferManager.setPageSize(segmentId, pageSize);
+			assert(supported);
+			(void) supported;
+
 			std::swap(this->name, name);
 			std::swap(this->primaryKey, primaryKey);
 			std::swap(this->attributes, attributes);
 		}
 
 		Relation(Relation&& other)
-		: SPSegment(other.bufferManager, other.id, other.pageCount()) {
+		: SPSegment(std::move(other)) {
 			*this = std::move(other);
 		}
 
@@ -55,25 +71,33 @@ namespace lsql {
 		}
 
 		/** Returns the segment id of the relation. */
-		const uint16_t segmentId() const {
+		uint16_t segmentId() const {
 			return Segment::id;
 		}
 
 		/** Returns the number of pages, this relations uses. */
-		const uint32_t pageCount() const {
+		uint32_t pageCount() const {
 			return Segment::pageCount;
 		}
 
+		/** Returns the size of the pages of this relation in bytes. */
+		uint32_t pageSize() const {
+			return uint32_t(Segment::getPageSize());
+		}
+
 	};
 
 	namespace serialization {
 
 		/**
 		 * A serialization context to inject a buffer manager during deserialization.
+		 * The version is set by the schema deserializer to the layout of the
+		 * catalog being read.
 		 */
 		struct BufferContext {
 			BufferManager& bufferManager;
-			BufferContext(BufferManager& bm) : bufferManager(bm) {}
+			uint16_t version;
+			BufferContext(BufferManager& bm) : bufferManager(bm), version(SCHEMA_VERSION) {}
 		};
 
 		template <>
@@ -83,6 +107,7 @@ namespace lsql {
 				size_t size = get_size(obj.name);
 				size += get_size(obj.segmentId());
 				size += get_size(obj.pageCount());
+				size += get_size(obj.pageSize());
 				size += get_size(obj.attributes);
 				size += get_size(obj.primaryKey);
 				return size;
@@ -96,6 +121,7 @@ namespace lsql {
 			static void apply(const Relation& obj, StreamType::iterator& res) {
 				serializer(obj.segmentId(), res);
 				serializer(obj.pageCount(), res);
+				serializer(obj.pageSize(),  res);
 				serializer(obj.name,        res);
 				serializer(obj.primaryKey,  res);
 				serializer(obj.attributes,  res);
@@ -109,12 +135,21 @@ namespace lsql {
 			static Relation apply(StreamType::const_iterator& begin,
 														StreamType::const_iterator end,
 														BufferContext* context = nullptr) {
-				return Relation(context->bufferManager,
-					deserialize_helper<uint16_t>::apply(begin,end),
-					deserialize_helper<uint32_t>::apply(begin,end),
-					std::move(deserialize_helper<std::string>::apply(begin,end)),
-					std::move(deserialize_helper<std::vector<unsigned>>::apply(begin,end)),
-					std::move(deserialize_helper<std::vector<Attribute>>::apply(begin,end)));
+				// Read fields in stream order; argument evaluation order is unspecified
+				uint16_t segmentId = deserialize_helper<uint16_t>::apply(begin,end);
+				uint32_t pageCount = deserialize_helper<uint32_t>::apply(begin,end);
+
+				// Legacy catalogs only knew the default page size
+				uint32_t pageSize = uint32_t(BufferFrame::SIZE);
+				if (context->version >= SCHEMA_VERSION_PAGE_SIZE)
+					pageSize = deserialize_helper<uint32_t>::apply(begin,end);
+
+				std::string name = deserialize_helper<std::string>::apply(begin,end);
+				std::vector<unsigned> primaryKey = deserialize_helper<std::vector<unsigned>>::apply(begin,end);
+				std::vector<Attribute> attributes = deserialize_helper<std::vector<Attribute>>::apply(begin,end);
+
+				return Relation(context->bufferManager, segmentId, pageCount, pageSize,
+					std::move(name), std::move(primaryKey), std::move(attributes));
 			}
 
 		};
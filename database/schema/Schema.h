@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -16,6 +17,12 @@
 #include "common/IDs.h"
 #include "Relation.h"
 
+/**
+ * Leading marker of versioned catalogs. Legacy catalogs start with the
+ * segment count instead, which never reaches this value.
+ */
+#define SCHEMA_FORMAT_TAG UINT16_MAX
+
 namespace lsql {
 
 	/**
@@ -43,7 +50,10 @@ namespace lsql {
 		struct get_size_helper<Schema> {
 
 			static size_t value(const Schema& obj) {
-				size_t size = get_size(obj.relations);
+				size_t size = get_size(uint16_t(SCHEMA_FORMAT_TAG));
+				size += get_size(uint16_t(SCHEMA_VERSION));
+				size += get_size(obj.segmentCount);
+				size += get_size(obj.relations);
 				return size;
 			}
 
@@ -53,6 +63,8 @@ namespace lsql {
 		struct serialize_helper<Schema> {
 
 			static void apply(const Schema& obj, StreamType::iterator& res) {
+				serializer(uint16_t(SCHEMA_FORMAT_TAG), res);
+				serializer(uint16_t(SCHEMA_VERSION), res);
 				serializer(obj.segmentCount, res);
 				serializer(obj.relations, res);
 			}
@@ -65,8 +77,19 @@ namespace lsql {
 			static Schema apply(StreamType::const_iterator& begin,
 													StreamType::const_iterator end,
 													BufferContext* context = nullptr) {
-				return Schema(deserialize_helper<uint16_t>::apply(begin, end),
-					std::move(deserialize_helper<std::vector<Relation>, BufferContext>::apply(begin, end, context)));
+				uint16_t segmentCount = deserialize_helper<uint16_t>::apply(begin, end);
+
+				if (segmentCount == SCHEMA_FORMAT_TAG) {
+					context->version = deserialize_helper<uint16_t>::apply(begin, end);
+					assert(context->version <= SCHEMA_VERSION);
+					segmentCount = deserialize_helper<uint16_t>::apply(begin, end);
+				} else {
+					context->version = SCHEMA_VERSION_LEGACY;
+				}
+
+				std::vector<Relation> relations =
+					deserialize_helper<std::vector<Relation>, BufferContext>::apply(begin, end, context);
+				return Schema(segmentCount, std::move(relations));
 			}
 
 		};
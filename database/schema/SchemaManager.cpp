@@ -6,6 +6,7 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <cassert>
 #include <cstdio>
 #include <sstream>
 
@@ -21,7 +22,7 @@ namespace lsql {
 
 		serialization::BufferContext context(bufferManager);
 		std::vector<uint8_t> serializedData;
-		serializedData.assign(frameData, frameData + BufferFrame::SIZE - 1);
+		serializedData.assign(frameData, frameData + frame.getSize() - 1);
 		schema = deserialize<Schema, serialization::BufferContext>(serializedData, &context);
 
 		bufferManager.unfixPage(frame, false);
@@ -49,9 +50,13 @@ namespace lsql {
 		return create(name, std::vector<Attribute>(), std::vector<unsigned>());
 	}
 
-	Relation& SchemaManager::create(const std::string& name, const std::vector<Attribute>& attributes, const std::vector<unsigned>& primaryKey) {
+	Relation& SchemaManager::create(const std::string& name, const std::vector<Attribute>& attributes, const std::vector<unsigned>& primaryKey, size_t pageSize) {
 		uint16_t segmentId = schema.segmentCount++;
 
+		bool supported = bufferManager.setPageSize(segmentId, pageSize);
+		assert(supported);
+		(void) supported;
+
 		schema.relations.emplace_back(bufferManager, segmentId, 0);
 
 		Relation& rel = schema.relations.back();
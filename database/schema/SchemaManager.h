@@ -41,11 +41,14 @@ namespace lsql {
 		Relation& lookup(const std::string& name);
 
 		/**
-		 *
+		 * Creates a new relation in its own segment. The page size is
+		 * recorded in the schema and registered with the buffer manager,
+		 * which must have a frame pool for it.
 		 */
 		Relation& create(const std::string& name,
 										 const std::vector<Attribute>& attributes,
-										 const std::vector<unsigned>& primaryKey);
+										 const std::vector<unsigned>& primaryKey,
+										 size_t pageSize = BufferFrame::SIZE);
 
 		/**
 		 *
@@ -0,0 +1,182 @@
+//
+//  FreeSpaceMap.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <sys/mman.h>
+
+#include "FreeSpaceMap.h"
+
+namespace lsql {
+
+	FreeSpaceMap::FreeSpaceMap(uint16_t segment, uint32_t pageCount)
+	: file(std::to_string(segment) + ".fsm", true), entries(nullptr), capacity(0), hint(0) {
+		// Cover all existing pages, which are unknown unless recorded
+		off_t bytes = (off_t(pageCount) / 2 / FREE_SPACE_GROWTH + 1) * FREE_SPACE_GROWTH;
+		if (pageCount > 0 && file.size() < bytes) {
+			bool success = file.allocate(bytes);
+			assert(success);
+			(void) success;
+		}
+
+		load();
+	}
+
+	FreeSpaceMap::~FreeSpaceMap() {
+		unload();
+	}
+
+	uint8_t FreeSpaceMap::getClass(int32_t freeSpace, size_t pageSize) {
+		if (freeSpace <= 0)
+			return 0;
+
+		uint64_t steps = uint64_t(freeSpace) * FREE_SPACE_STEPS / pageSize;
+		return uint8_t(std::min<uint64_t>(steps, FREE_SPACE_CLASSES - 1));
+	}
+
+	uint8_t FreeSpaceMap::getRequiredClass(int32_t size, size_t pageSize) {
+		if (size <= 0)
+			return 0;
+
+		uint64_t steps = (uint64_t(size) * FREE_SPACE_STEPS + pageSize - 1) / pageSize;
+		return uint8_t(std::min<uint64_t>(steps, FREE_SPACE_CLASSES - 1));
+	}
+
+	void FreeSpaceMap::update(uint32_t page, uint8_t spaceClass) {
+		assert(page < FREE_SPACE_PAGES && spaceClass < FREE_SPACE_CLASSES);
+
+		latch.lock(false);
+		while (page >= capacity) {
+			latch.unlock();
+			extend(page);
+			latch.lock(false);
+		}
+
+		// Two pages share a byte, so concurrent updates must not collide
+		std::atomic<uint8_t>& entry = reinterpret_cast<std::atomic<uint8_t>&>(entries[page / 2]);
+		unsigned shift = (page % 2) * 4;
+
+		uint8_t value = entry.load(std::memory_order_relaxed);
+		uint8_t updated;
+		do {
+			updated = uint8_t((value & ~(0xF << shift)) | ((spaceClass + 1) << shift));
+		} while (value != updated && !entry.compare_exchange_weak(value, updated));
+
+		// The page is latched by the caller, so its bits cannot race
+		uint8_t previous = (value >> shift) & 0xF;
+		if (previous != spaceClass + 1) {
+			pages[previous]->clear(page);
+			pages[spaceClass + 1]->set(page);
+		}
+
+		latch.unlock();
+	}
+
+	uint32_t FreeSpaceMap::find(uint8_t minClass, uint32_t pageCount, uint32_t skipPage) {
+		uint32_t start = hint.load(std::memory_order_relaxed);
+		if (start >= pageCount)
+			start = 0;
+
+		latch.lock(false);
+
+		// Pages of unknown free space come last, they are checked by the caller
+		uint32_t page = FREE_SPACE_NO_PAGE;
+		for (uint8_t entry = minClass + 1; entry <= FREE_SPACE_CLASSES && page == FREE_SPACE_NO_PAGE; ++entry)
+			page = find(entry, start, pageCount, skipPage);
+		if (page == FREE_SPACE_NO_PAGE)
+			page = find(0, start, pageCount, skipPage);
+
+		// Classes round down, so a page of the class below might still fit
+		bool speculative = false;
+		if (page == FREE_SPACE_NO_PAGE && minClass > 0) {
+			page = find(minClass, start, pageCount, skipPage);
+			speculative = page != FREE_SPACE_NO_PAGE;
+		}
+
+		latch.unlock();
+
+		// Continue behind a page which is likely too full for the next probe
+		if (page != FREE_SPACE_NO_PAGE)
+			hint.store(speculative ? page + 1 : page, std::memory_order_relaxed);
+		return page;
+	}
+
+	uint8_t FreeSpaceMap::get(uint32_t page) const {
+		if (page >= capacity)
+			return 0;
+
+		const std::atomic<uint8_t>& entry = reinterpret_cast<const std::atomic<uint8_t>&>(entries[page / 2]);
+		return (entry.load(std::memory_order_relaxed) >> ((page % 2) * 4)) & 0xF;
+	}
+
+	uint32_t FreeSpaceMap::find(uint8_t entry, uint32_t start, uint32_t pageCount, uint32_t skipPage) const {
+		const Bitmap& bitmap = *pages[entry];
+		uint64_t limit = std::min<uint64_t>(pageCount, capacity);
+
+		// Search behind the start first, then wrap around
+		uint64_t ranges[2][2] = {{start, limit}, {0, std::min<uint64_t>(start, limit)}};
+		for (auto& range : ranges) {
+			uint64_t page = bitmap.next(range[0]);
+			if (page == skipPage)
+				page = bitmap.next(page + 1);
+
+			if (page < range[1])
+				return uint32_t(page);
+		}
+
+		return FREE_SPACE_NO_PAGE;
+	}
+
+	void FreeSpaceMap::load() {
+		capacity = uint64_t(file.size()) * 2;
+		if (capacity > 0) {
+			void* memory = mmap(nullptr, size_t(file.size()), PROT_READ | PROT_WRITE, MAP_SHARED, file.descriptor(), 0);
+			assert(memory != MAP_FAILED);
+			entries = static_cast<uint8_t*>(memory);
+		}
+
+		for (auto& bitmap : pages)
+			bitmap = new Bitmap(capacity);
+
+		for (uint64_t page = 0; page < capacity; ++page)
+			pages[get(uint32_t(page))]->set(page);
+	}
+
+	void FreeSpaceMap::unload() {
+		for (auto& bitmap : pages)
+			delete bitmap;
+
+		if (entries != nullptr)
+			munmap(entries, size_t(capacity / 2));
+		entries = nullptr;
+		capacity = 0;
+	}
+
+	void FreeSpaceMap::extend(uint32_t page) {
+		latch.lock(true);
+
+		if (page >= capacity) {
+			// Grow geometrically, so that rebuilding the bitmaps amortizes
+			off_t bytes = (off_t(page) / 2 / FREE_SPACE_GROWTH + 1) * FREE_SPACE_GROWTH;
+			bytes = std::max<off_t>(bytes, std::min<off_t>(file.size() * 2, FREE_SPACE_PAGES / 2));
+
+			// Never shrink a file grown by another instance of the segment
+			if (file.size() < bytes) {
+				bool success = file.allocate(bytes);
+				assert(success);
+				(void) success;
+			}
+
+			unload();
+			load();
+		}
+
+		latch.unlock();
+	}
+
+}
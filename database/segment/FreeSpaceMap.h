@@ -0,0 +1,159 @@
+//
+//  FreeSpaceMap.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "utils/Bitmap.h"
+#include "utils/File.h"
+#include "utils/Latch.h"
+
+#define FREE_SPACE_CLASSES 15
+#define FREE_SPACE_STEPS 16
+#define FREE_SPACE_PAGES (uint64_t(1) << 24)
+#define FREE_SPACE_GROWTH 4096
+#define FREE_SPACE_NO_PAGE UINT32_MAX
+
+namespace lsql {
+
+	/**
+	 * Records the approximate free space of all pages in a slotted page
+	 * segment, so that inserts find a page with enough room without fixing
+	 * full pages.
+	 *
+	 * Each page is described by four bits. Zero means that the free space of
+	 * the page is unknown, for instance because the segment has been written
+	 * before the map existed. Otherwise, the value is the free space class of
+	 * the page plus one. A page of class @c c has at least @c c sixteenths of
+	 * its size free, so a class never overstates the free space.
+	 *
+	 * The map is stored in a file next to the segment, named after the segment
+	 * with the suffix @c .fsm, which is mapped into memory. Updates are plain
+	 * atomic stores, and the operating system writes them back. As the map is
+	 * only a hint, callers verify the free space of a page after fixing it.
+	 * Maps which are outdated after a crash are corrected on the way.
+	 *
+	 * In memory, every entry value has a @c Bitmap of the pages carrying it,
+	 * so searches skip whole ranges of full pages instead of scanning them.
+	 * The mapping and the bitmaps cover the pages of the file, which grows
+	 * geometrically. Growing replaces both under an exclusive latch, while
+	 * all other operations hold it in shared mode.
+	 */
+	class FreeSpaceMap {
+
+		File<void> file;
+		uint8_t* entries;
+		uint64_t capacity;
+		Bitmap* pages[FREE_SPACE_CLASSES + 1];
+		std::atomic<uint32_t> hint;
+		Latch latch;
+
+	public:
+
+		/**
+		 * Opens the free space map of a segment, creating it if necessary.
+		 *
+		 * @param segment   The identifier of the segment.
+		 * @param pageCount The number of pages in the segment, which the map
+		 *                  is sized for initially.
+		 */
+		explicit FreeSpaceMap(uint16_t segment, uint32_t pageCount = 0);
+
+		/** Prevent the copy constructor. */
+		FreeSpaceMap(const FreeSpaceMap& other) = delete;
+
+		/** Prevent copy assignments. */
+		FreeSpaceMap& operator=(const FreeSpaceMap& other) = delete;
+
+		/**
+		 * Unmaps and closes the free space map.
+		 */
+		~FreeSpaceMap();
+
+		/**
+		 * Returns the free space class of a page with the given free space.
+		 *
+		 * @param freeSpace The free space of the page in bytes.
+		 * @param pageSize  The size of the page in bytes.
+		 */
+		static uint8_t getClass(int32_t freeSpace, size_t pageSize);
+
+		/**
+		 * Returns the lowest class guaranteeing the given free space, or the
+		 * highest class if none does.
+		 *
+		 * @param size     The free space needed in bytes.
+		 * @param pageSize The size of the page in bytes.
+		 */
+		static uint8_t getRequiredClass(int32_t size, size_t pageSize);
+
+		/**
+		 * Records the free space class of a page. The page must be latched
+		 * exclusively by the caller.
+		 *
+		 * @param page       The page number within the segment.
+		 * @param spaceClass The free space class of the page.
+		 */
+		void update(uint32_t page, uint8_t spaceClass);
+
+		/**
+		 * Searches a page which is likely to have enough free space. Pages
+		 * of the lowest sufficient class are preferred, followed by pages of
+		 * unknown free space. Pages of the class just below the required one
+		 * might fit as well and are returned last, so that almost full pages
+		 * are not abandoned. Within a class, the search continues after the
+		 * page found last, so that consecutive inserts usually find the same
+		 * page. After a page of the class below, it continues behind it.
+		 *
+		 * @param minClass  The class required, see @c getRequiredClass.
+		 * @param pageCount The number of pages in the segment.
+		 * @param skipPage  A page to ignore.
+		 *
+		 * @return The page number, or @c FREE_SPACE_NO_PAGE if all pages are
+		 *         known to be too full.
+		 */
+		uint32_t find(uint8_t minClass, uint32_t pageCount, uint32_t skipPage = FREE_SPACE_NO_PAGE);
+
+	private:
+
+		/**
+		 * Returns the raw entry of a page. Zero means unknown. The latch must
+		 * be held by the caller.
+		 */
+		uint8_t get(uint32_t page) const;
+
+		/**
+		 * Searches a page with the given raw entry in the range before
+		 * @c pageCount, starting at @c start and wrapping around.
+		 */
+		uint32_t find(uint8_t entry, uint32_t start, uint32_t pageCount, uint32_t skipPage) const;
+
+		/**
+		 * Maps the file and builds the bitmaps from its entries. The latch
+		 * must be held exclusively, or not be shared yet.
+		 */
+		void load();
+
+		/**
+		 * Unmaps the file and releases the bitmaps.
+		 */
+		void unload();
+
+		/**
+		 * Grows the file and the mapping to contain the entry of the given
+		 * page. The latch must not be held by the caller.
+		 */
+		void extend(uint32_t page);
+
+	};
+
+}
@@ -0,0 +1,37 @@
+//
+//  RecordView.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <utility>
+
+#include "RecordView.h"
+
+namespace lsql {
+
+	RecordView::RecordView()
+	: data(nullptr), size(0) {
+	}
+
+	RecordView::RecordView(PageGuard&& guard, const char* data, uint32_t size)
+	: guard(std::move(guard)), data(data), size(size) {
+	}
+
+	const char* RecordView::getData() const {
+		return data;
+	}
+
+	uint32_t RecordView::getSize() const {
+		return size;
+	}
+
+	void RecordView::release() {
+		guard.release();
+		data = nullptr;
+		size = 0;
+	}
+
+}
@@ -0,0 +1,65 @@
+//
+//  RecordView.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+
+#include "buffer/PageGuard.h"
+
+namespace lsql {
+
+	/**
+	 * Refers to the data of a record directly within its page.
+	 *
+	 * Unlike a @c Record, a view does not copy the data. Instead, it keeps the
+	 * page fixed in shared mode with a @c PageGuard for as long as the view or
+	 * any copy of it exists. Thus, views must be released before the record
+	 * is modified by the same thread. See @c SPSegment::lookupView.
+	 */
+	class RecordView {
+
+		PageGuard guard;
+		const char* data;
+		uint32_t size;
+
+	public:
+
+		/**
+		 * Creates an empty view.
+		 */
+		RecordView();
+
+		/**
+		 * Creates a view of record data within a guarded page.
+		 *
+		 * @param guard A guard keeping the page fixed.
+		 * @param data  A pointer to the record data within the page.
+		 * @param size  The size of the record in bytes.
+		 */
+		RecordView(PageGuard&& guard, const char* data, uint32_t size);
+
+		/**
+		 * Returns a pointer to the record data or @c nullptr if empty.
+		 */
+		const char* getData() const;
+
+		/**
+		 * Returns the size of this record in bytes.
+		 */
+		uint32_t getSize() const;
+
+		/**
+		 * Unfixes the page before the view is destroyed. Afterwards, the view
+		 * is empty.
+		 */
+		void release();
+
+	};
+
+}
@@ -16,20 +16,27 @@
 namespace lsql {
 
 	SPSegment::SPSegment(BufferManager& bufferManager, uint16_t id, uint32_t pageCount)
-	: Segment(bufferManager, id, pageCount) {}
+	: Segment(bufferManager, id, pageCount), freeSpace(nullptr) {}
 
-	Record SPSegment::lookup(TID id) {
-		BufferFrame& frame = fixPage(id, false);
+	SPSegment::SPSegment(SPSegment&& other)
+	: Segment(other), freeSpace(other.freeSpace.exchange(nullptr)) {}
 
-		SlottedPage sp(this, frame);
-		Record record = sp.lookup(id);
+	SPSegment::~SPSegment() {
+		delete freeSpace.load();
+	}
 
-		unfixPage(frame, false);
-		return record;
+	Record SPSegment::lookup(TID id) {
+		RecordView view = lookupView(id);
+		return Record(view.getSize(), view.getData());
 	}
 
-	TID SPSegment::insert(const Record& record) {
-		BufferFrame& frame = findFreeFrame(record.getSize());
+	RecordView SPSegment::lookupView(TID id) {
+		BufferFrame& frame = fixPage(id, false);
+		return SlottedPage(this, frame).lookupView(id, PageGuard(bufferManager, frame));
+	}
+
+	TID SPSegment::insert(const Record& record, uint32_t skipPage) {
+		BufferFrame& frame = findFreeFrame(record.getSize(), skipPage);
 
 		SlottedPage sp(this, frame);
 		TID id = sp.createSlot();
@@ -39,6 +46,17 @@ namespace lsql {
 		return id;
 	}
 
+	std::vector<TID> SPSegment::insertBatch(const std::vector<Record>& records) {
+		std::vector<TID> ids;
+		ids.reserve(records.size());
+
+		Appender appender(this);
+		for (const Record& record : records)
+			ids.push_back(appender.append(record));
+
+		return ids;
+	}
+
 	bool SPSegment::update(TID id, const Record& record, bool allowRedirect) {
 		BufferFrame& frame = fixPage(id, true);
 
@@ -67,14 +85,28 @@ namespace lsql {
 		return Iterator(this, pageCount);
 	}
 
-	BufferFrame& SPSegment::findFreeFrame(int32_t requestedSize, uint32_t startPage) {
-		// Try to find a frame with enough space
-		for (uint32_t page = startPage; page < getPageCount(); ++page) {
-			BufferFrame& frame = fixPage(PID(getID(), page), true);
+	BufferFrame& SPSegment::findFreeFrame(int32_t requestedSize, uint32_t skipPage) {
+		uint8_t minClass = FreeSpaceMap::getRequiredClass(requestedSize, getPageSize());
+
+		// Try to find a frame with enough space. Checking a page in update
+		// mode does not block readers, and the free space cannot shrink
+		// before upgrading the lock. Latching the page of a redirecting
+		// update again would deadlock.
+		for (unsigned i = 0; i < SP_SEGMENT_PROBES; ++i) {
+			uint32_t page = getFreeSpaceMap().find(minClass, getPageCount(), skipPage);
+			if (page == FREE_SPACE_NO_PAGE)
+				break;
+
+			BufferFrame& frame = fixPageUpdate(PID(getID(), page));
+			SlottedPage sp(this, frame);
 
-			if (SlottedPage(this, frame).getFreeSpace() >= requestedSize)
+			if (sp.getFreeSpace() >= requestedSize) {
+				upgradePage(frame);
 				return frame;
+			}
 
+			// The map was outdated or too coarse for this record
+			sp.recordFreeSpace();
 			unfixPage(frame, false);
 		}
 
@@ -85,4 +117,18 @@ namespace lsql {
 		return frame;
 	}
 
+	FreeSpaceMap& SPSegment::getFreeSpaceMap() {
+		FreeSpaceMap* map = freeSpace.load(std::memory_order_acquire);
+		if (map != nullptr)
+			return *map;
+
+		// Discard the map, if another thread was faster
+		FreeSpaceMap* created = new FreeSpaceMap(getID(), getPageCount());
+		if (freeSpace.compare_exchange_strong(map, created))
+			return *created;
+
+		delete created;
+		return *map;
+	}
+
 }
\ No newline at end of file
@@ -8,11 +8,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
 #include "common/IDs.h"
+#include "FreeSpaceMap.h"
 #include "Segment.h"
 #include "Record.h"
+#include "RecordView.h"
+
+#define SP_SEGMENT_NO_PAGE FREE_SPACE_NO_PAGE
+#define SP_SEGMENT_PROBES 4
 
 namespace lsql {
 
@@ -21,9 +28,18 @@ namespace lsql {
 	 *
 	 * SPSegment handles CRUD for records in slotted pages. All operations within
 	 * a page are delegated to @c SlottedPage.
+	 *
+	 * Slotted pages record their free space in a @c FreeSpaceMap whenever they
+	 * change, so inserts go straight to a page with enough room. The map is
+	 * opened on the first modification, so segments which are only read never
+	 * create it.
 	 */
 	class SPSegment : protected Segment {
 
+		friend class SlottedPage;
+
+		std::atomic<FreeSpaceMap*> freeSpace;
+
 	public:
 
 		/**
@@ -31,6 +47,11 @@ namespace lsql {
 		 */
 		class Iterator;
 
+		/**
+		 * Streams records into fresh pages. See @c insertBatch.
+		 */
+		class Appender;
+
 		/**
 		 * Creates a wrapper for segments containing slotted pages.
 		 *
@@ -40,6 +61,22 @@ namespace lsql {
 		 */
 		SPSegment(BufferManager& bufferManager, uint16_t id, uint32_t pageCount = 0);
 
+		/**
+		 * Takes over the segment and the free space map of another instance.
+		 */
+		SPSegment(SPSegment&& other);
+
+		/** Prevent the copy constructor. */
+		SPSegment(const SPSegment& other) = delete;
+
+		/** Prevent copy assignments. */
+		SPSegment& operator=(const SPSegment& other) = delete;
+
+		/**
+		 * Closes the free space map.
+		 */
+		~SPSegment();
+
 		/**
 		 * Searches an existing record within the segment.
 		 *
@@ -47,14 +84,40 @@ namespace lsql {
 		 */
 		Record lookup(TID id);
 
+		/**
+		 * Searches an existing record within the segment without copying it.
+		 * The returned view keeps the page fixed in shared mode until it is
+		 * released, so the record must not be modified meanwhile by the same
+		 * thread.
+		 *
+		 * @param id The tuple identifier of the record to find.
+		 */
+		RecordView lookupView(TID id);
+
 		/**
 		 * Inserts a new record into the segment.
 		 * Once inserted, the tuple identifier of the record will never change.
 		 *
-		 * @param record A record containing data to insert.
+		 * @param record   A record containing data to insert.
+		 * @param skipPage For internal use only.
+		 *
 		 * @return The tuple identifier of the new record.
 		 */
-		TID insert(const Record& record);
+		TID insert(const Record& record, uint32_t skipPage = SP_SEGMENT_NO_PAGE);
+
+		/**
+		 * Inserts many records at once into new pages at the end of the
+		 * segment. Pages are filled one after another, each fixed only once,
+		 * and existing pages are not searched for free space. This is much
+		 * faster than inserting the records one by one when loading data.
+		 *
+		 * To load records which do not fit into memory at once, use an
+		 * @c Appender instead.
+		 *
+		 * @param records The records to insert.
+		 * @return The tuple identifiers of the records in the same order.
+		 */
+		std::vector<TID> insertBatch(const std::vector<Record>& records);
 
 		/**
 		 * Updates the specified record with new data.
@@ -88,15 +151,23 @@ namespace lsql {
 	private:
 
 		/**
-		 * Searches for a page which will fit the given size.
+		 * Searches for a page which will fit the given size. Candidates are
+		 * taken from the free space map. If none of the first
+		 * @c SP_SEGMENT_PROBES candidates fits, a new page is added.
 		 *
 		 * @param requestedSize The minimum of free space in the page.
-		 * @param startPage     The page to start searching from.
+		 * @param skipPage      A page already latched by the caller.
+		 */
+		BufferFrame& findFreeFrame(int32_t requestedSize, uint32_t skipPage = SP_SEGMENT_NO_PAGE);
+
+		/**
+		 * Returns the free space map of this segment, opening it if necessary.
 		 */
-		BufferFrame& findFreeFrame(int32_t requestedSize, uint32_t startPage = 0);
+		FreeSpaceMap& getFreeSpaceMap();
 
 	};
 
 }
 
 #include "SPSegmentIterator.h"
+#include "SPSegmentAppender.h"
@@ -0,0 +1,56 @@
+//
+//  SPSegmentAppender.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+
+#include "SlottedPage.h"
+#include "SPSegmentAppender.h"
+
+namespace lsql {
+
+	typedef SPSegment::Appender SSA;
+
+	SSA::Appender(SPSegment* segment)
+	: segment(segment), frame(nullptr), page(nullptr) {
+	}
+
+	SSA::~Appender() {
+		finish();
+	}
+
+	TID SSA::append(const Record& record) {
+		TID id = NULL_TID;
+		if (page != nullptr && page->append(record, id))
+			return id;
+
+		finish();
+
+		frame = &segment->fixPage(segment->addPage(), true);
+		page = new SlottedPage(segment, *frame);
+		page->reset();
+
+		bool appended = page->append(record, id);
+		assert(appended);
+		(void) appended;
+
+		return id;
+	}
+
+	void SSA::finish() {
+		if (page == nullptr)
+			return;
+
+		page->recordFreeSpace();
+		segment->unfixPage(*frame, true);
+
+		delete page;
+		page = nullptr;
+		frame = nullptr;
+	}
+
+}
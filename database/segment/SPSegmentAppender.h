@@ -0,0 +1,70 @@
+//
+//  SPSegmentAppender.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include "SlottedPage.h"
+#include "SPSegment.h"
+
+namespace lsql {
+
+	class SlottedPage;
+
+	/**
+	 * Appends records to a slotted page segment for bulk loads.
+	 *
+	 * The appender keeps one fresh page fixed exclusively and writes records
+	 * into it back to back. Once a record does not fit anymore, the page is
+	 * released as dirty, its free space is recorded and the next page is
+	 * added to the segment. Records never go into pages which existed before.
+	 */
+	class SPSegment::Appender {
+
+		SPSegment* segment;
+		BufferFrame* frame;
+		SlottedPage* page;
+
+	public:
+
+		/**
+		 * Creates an appender for the given segment. No page is added until
+		 * the first record is appended.
+		 *
+		 * @param segment The segment to append to.
+		 */
+		explicit Appender(SPSegment* segment);
+
+		/** Prevent the copy constructor. */
+		Appender(const Appender& other) = delete;
+
+		/** Prevent copy assignments. */
+		Appender& operator=(const Appender& other) = delete;
+
+		/**
+		 * Releases the current page. See @c finish.
+		 */
+		~Appender();
+
+		/**
+		 * Appends a record to the current page, or to a new page if it is
+		 * full. The record must fit into an empty page.
+		 *
+		 * @param record A record containing data to insert.
+		 * @return The tuple identifier of the new record.
+		 */
+		TID append(const Record& record);
+
+		/**
+		 * Releases the current page, so that other threads can access its
+		 * records. Appending again continues on a new page.
+		 */
+		void finish();
+
+	};
+
+}
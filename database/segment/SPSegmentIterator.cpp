@@ -14,19 +14,29 @@ namespace lsql {
 	typedef SPSegment::Iterator SSI;
 
 	SSI::Iterator(SPSegment* segment, uint32_t start)
-	: segment(segment), pageId(start), page(nullptr), frame(nullptr) {
+	: segment(segment), pageId(start), frame(nullptr), page(nullptr) {
 	}
 
-	SSI::Iterator(const SSI& iterator) {
+	SSI::Iterator(const SSI& iterator)
+	: frame(nullptr), page(nullptr) {
 		*this = iterator;
 	}
 
 	SSI::~Iterator() {
-		if (page != nullptr)
+		if (page != nullptr) {
+			delete page;
 			segment->unfixPage(*frame, false);
+		}
 	}
 
 	SSI& SSI::operator=(const SSI& iterator) {
+		if (page != nullptr) {
+			delete page;
+			segment->unfixPage(*frame, false);
+			frame = nullptr;
+			page = nullptr;
+		}
+
 		segment = iterator.segment;
 		pageId  = iterator.pageId;
 
@@ -45,6 +55,7 @@ namespace lsql {
 		assert(segment != nullptr);
 
 		if (page != nullptr) {
+			delete page;
 			segment->unfixPage(*frame, false);
 			frame = nullptr;
 			page = nullptr;
@@ -61,7 +72,7 @@ namespace lsql {
 	SlottedPage* SSI::operator->() const {
 		if (page == nullptr) {
 			SSI* that = const_cast<SSI*>(this);
-			that->frame = &segment->fixPage(PID(segment->getID(), pageId), false);
+			that->frame = &segment->fixPage(PID(segment->getID(), pageId), false, &that->ring);
 			that->page = new SlottedPage(segment, *frame);
 		}
 
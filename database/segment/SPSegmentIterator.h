@@ -21,6 +21,7 @@ namespace lsql {
 		uint32_t pageId;
 		BufferFrame* frame;
 		SlottedPage* page;
+		BufferRing ring;
 
 	public:
 
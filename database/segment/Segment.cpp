@@ -22,9 +22,23 @@ namespace lsql {
 		return pageCount;
 	}
 
-	BufferFrame& Segment::fixPage(PID id, bool exclusive) {
+	size_t Segment::getPageSize() const {
+		return bufferManager.getPageSize(id);
+	}
+
+	BufferFrame& Segment::fixPage(PID id, bool exclusive, BufferRing* ring) {
+		assert(id.segment() == this->id);
+		return bufferManager.fixPage(id, exclusive, ring);
+	}
+
+	BufferFrame& Segment::fixPageUpdate(PID id) {
 		assert(id.segment() == this->id);
-		return bufferManager.fixPage(id, exclusive);
+		return bufferManager.fixPageUpdate(id);
+	}
+
+	void Segment::upgradePage(BufferFrame& frame) {
+		assert(frame.getId().segment() == id);
+		bufferManager.upgradePage(frame);
 	}
 
 	void Segment::unfixPage(BufferFrame& frame, bool isDirty) {
@@ -32,6 +46,24 @@ namespace lsql {
 		bufferManager.unfixPage(frame, isDirty);
 	}
 
+	BufferFrame& Segment::fixPageOptimistic(PID id, uint64_t& version) {
+		assert(id.segment() == this->id);
+		return bufferManager.fixPageOptimistic(id, version);
+	}
+
+	bool Segment::validatePage(const BufferFrame& frame, uint64_t version) const {
+		return bufferManager.validatePage(frame, version);
+	}
+
+	bool Segment::lockPage(BufferFrame& frame, uint64_t version, bool exclusive) {
+		return bufferManager.lockPage(frame, version, exclusive);
+	}
+
+	void Segment::unfixPageOptimistic(BufferFrame& frame) {
+		assert(frame.getId().segment() == id);
+		bufferManager.unfixPageOptimistic(frame);
+	}
+
 	PID Segment::addPage() {
 		return PID(id, pageCount++);
 	}
@@ -47,6 +47,12 @@ namespace lsql {
 		 */
 		uint32_t getPageCount() const;
 
+		/**
+		 * Returns the size of all pages in this segment in bytes. See
+		 * @c BufferManager::setPageSize.
+		 */
+		size_t getPageSize() const;
+
 		/**
 		 * Fixes the specified page in the underlying @c BufferManager instance. 
 		 * This method might fail, if the requested page does not belong to this
@@ -55,10 +61,26 @@ namespace lsql {
 		 * @param id        An identifier for the page to load.
 		 * @param exclusive Whether or not this frame is exclusive to the caller of 
 		 *                  this method.
+		 * @param ring      An optional ring to recycle frames for scans. See
+		 *                  @c BufferManager::fixPage.
 		 *
 		 * @return A reference to the buffer frame. See @c BufferFrame for more details.
 		 */
-		BufferFrame& fixPage(PID id, bool exclusive);
+		BufferFrame& fixPage(PID id, bool exclusive, BufferRing* ring = nullptr);
+
+		/**
+		 * Fixes the specified page in update mode. See
+		 * @c BufferManager::fixPageUpdate for more information.
+		 *
+		 * @param id An identifier for the page to load.
+		 * @return A reference to the buffer frame.
+		 */
+		BufferFrame& fixPageUpdate(PID id);
+
+		/**
+		 * Upgrades a frame fixed by @c fixPageUpdate to an exclusive lock.
+		 */
+		void upgradePage(BufferFrame& frame);
 
 		/**
 		 * Releases the given frame. This method might fail, if the page does not
@@ -66,6 +88,33 @@ namespace lsql {
 		 */
 		void unfixPage(BufferFrame& frame, bool isDirty);
 
+		/**
+		 * Fixes the specified page for optimistic reading. See
+		 * @c BufferManager::fixPageOptimistic for more information.
+		 *
+		 * @param id      An identifier for the page to load.
+		 * @param version Receives the version of the frame.
+		 *
+		 * @return A reference to the buffer frame.
+		 */
+		BufferFrame& fixPageOptimistic(PID id, uint64_t& version);
+
+		/**
+		 * Checks whether data read optimistically from the frame is still valid.
+		 */
+		bool validatePage(const BufferFrame& frame, uint64_t version) const;
+
+		/**
+		 * Locks an optimistically fixed frame, if it has not been modified.
+		 * See @c BufferManager::lockPage for more information.
+		 */
+		bool lockPage(BufferFrame& frame, uint64_t version, bool exclusive);
+
+		/**
+		 * Releases a frame fixed by @c fixPageOptimistic.
+		 */
+		void unfixPageOptimistic(BufferFrame& frame);
+
 		/**
 		 * Adds a new page to this segment.
 		 * This also increments the page count.
@@ -9,6 +9,7 @@
 #include <cstring>
 #include <cassert>
 #include <algorithm>
+#include <utility>
 #include <vector>
 
 #include "SlottedPage.h"
@@ -16,20 +17,27 @@
 namespace lsql {
 
 	SlottedPage::SlottedPage(SPSegment* segment, BufferFrame& frame)
-	: segment(segment), pid(frame.getId()) {
+	: segment(segment), frame(&frame), pid(frame.getId()), size(int32_t(frame.getSize())) {
 		data = static_cast<char*>(frame.getData());
 		header = static_cast<Header*>(frame.getData());
-		slots = reinterpret_cast<Slot*>(data + sizeof(Header));
+		slots = data + sizeof(Header);
+		packed = header->version == SLOTTED_PAGE_VERSION_PACKED;
 	}
 
 	void SlottedPage::reset() {
+		assert(size < (1 << 24));
+		packed = size <= int32_t(SLOTTED_PAGE_PACKED_SIZE);
+
 		header->count = 0;
-		header->dataStart = int32_t(BufferFrame::SIZE);
+		header->firstFree = SLOTTED_PAGE_NO_SLOT;
+		header->dataStart = size;
+		header->version = packed ? SLOTTED_PAGE_VERSION_PACKED : SLOTTED_PAGE_VERSION_WIDE;
 		header->usedSpace = 0;
+		recordFreeSpace();
 	}
 
 	Record SlottedPage::lookup(TID id) const {
-		Slot& slot = slots[id.tuple()];
+		Slot slot = getSlot(id.tuple());
 		assert(id.tuple() < header->count);
 		assert(slot.type != SLOT_EMPTY);
 
@@ -41,24 +49,51 @@ namespace lsql {
 		}
 	}
 
+	RecordView SlottedPage::lookupView(TID id, PageGuard&& guard) const {
+		Slot slot = getSlot(id.tuple());
+		assert(id.tuple() < header->count);
+		assert(slot.type != SLOT_EMPTY);
+
+		if (slot.type == SLOT_REDIRECT) {
+			// Do not hold both pages, redirects may point in either direction
+			TID redirectTID = *getData<TID>(slot);
+			guard.release();
+			return segment->lookupView(redirectTID);
+		} else {
+			return RecordView(std::move(guard), getData(slot), uint32_t(slot.size));
+		}
+	}
+
 	TID SlottedPage::createSlot() {
-		for (uint16_t i = 0; i < header->count; ++i)
-			if (slots[i].type == SLOT_EMPTY)
-				return TID(pid.segment(), pid.page(), i);
+		upgrade();
+
+		uint16_t id = header->firstFree;
+		if (id != SLOTTED_PAGE_NO_SLOT) {
+			unlinkFreeSlot(id);
+		} else {
+			id = header->count++;
+
+			Slot slot = Slot();
+			slot.type = SLOT_EMPTY;
+			setSlot(id, slot);
+		}
 
-		uint16_t id = header->count++;
 		return TID(pid.segment(), pid.page(), id);
 	}
 
 	void SlottedPage::insert(TID id, const Record& record) {
 		assert(id.tuple() < header->count);
 
-		// Reset the slot for compression
-		Slot& slot = slots[id.tuple()];
+		// Reset the slot for compression. A record reinserted by an update
+		// releases its old space first.
+		Slot slot = getSlot(id.tuple());
+		if (slot.type != SLOT_EMPTY)
+			header->usedSpace -= slot.size;
 		slot.type = SLOT_EMPTY;
+		setSlot(id.tuple(), slot);
 
 		// Check if we need to compress data
-		int32_t freeSpace = header->dataStart - sizeof(Header) - header->count * sizeof(Slot);
+		int32_t freeSpace = header->dataStart - sizeof(Header) - header->count * getSlotSize();
 		if (int32_t(record.getSize()) > freeSpace)
 			compressData();
 
@@ -66,6 +101,7 @@ namespace lsql {
 		slot.type = SLOT_USED;
 		slot.size = record.getSize();
 		slot.offset = header->dataStart - slot.size;
+		setSlot(id.tuple(), slot);
 
 		// Update header information
 		header->dataStart = slot.offset;
@@ -73,10 +109,31 @@ namespace lsql {
 
 		// Copy data to the page
 		std::memcpy(getData(slot), record.getData(), slot.size);
+		recordFreeSpace();
+	}
+
+	bool SlottedPage::append(const Record& record, TID& id) {
+		// The slot array and the data grow towards each other
+		int32_t headerEnd = sizeof(Header) + (header->count + 1) * getSlotSize();
+		if (header->dataStart - headerEnd < int32_t(record.getSize()))
+			return false;
+
+		Slot slot;
+		slot.type = SLOT_USED;
+		slot.size = record.getSize();
+		slot.offset = header->dataStart - slot.size;
+		setSlot(header->count, slot);
+
+		header->dataStart = slot.offset;
+		header->usedSpace += slot.size;
+		std::memcpy(getData(slot), record.getData(), slot.size);
+
+		id = TID(pid.segment(), pid.page(), header->count++);
+		return true;
 	}
 
 	bool SlottedPage::update(TID id, const Record& record, bool allowRedirect) {
-		Slot& slot = slots[id.tuple()];
+		Slot slot = getSlot(id.tuple());
 		assert(id.tuple() < header->count);
 		assert(slot.type != SLOT_EMPTY);
 
@@ -89,37 +146,40 @@ namespace lsql {
 				// There was no space in the redirected page, so move the redirection
 				// to a new page and remove the old record.
 				segment->remove(*redirectTID);
-				*redirectTID = segment->insert(record);
+				*redirectTID = segment->insert(record, pid.page());
 			}
 
 		// Downsize the data slot
-		} else if (record.getSize() <= slot.size) {
-			replaceRecord(slot, record);
+		} else if (int32_t(record.getSize()) <= slot.size) {
+			replaceRecord(id.tuple(), slot, record);
 
 		// The current data slot might not fit, so reinsert with the same id
-		} else if (record.getSize() <= getFreeSpace()) {
+		} else if (int32_t(record.getSize()) <= getFreeSpace()) {
 			insert(id, record);
 
 		// There is no space in this page, so redirect to a new page
 		} else if (allowRedirect) {
 			slot.type = SLOT_REDIRECT;
-			TID redirectTID = segment->insert(record);
+			TID redirectTID = segment->insert(record, pid.page());
 			Record redirectRecord(sizeof(TID), reinterpret_cast<char*>(&redirectTID));
-			replaceRecord(slot, redirectRecord);
+			replaceRecord(id.tuple(), slot, redirectRecord);
 
 		// There is no space but we must not redirect, so fail
 		} else {
 			return false;
 		}
 
+		recordFreeSpace();
 		return true;
 	}
 
 	void SlottedPage::remove(TID id) {
-		Slot& slot = slots[id.tuple()];
+		Slot slot = getSlot(id.tuple());
 		assert(id.tuple() < header->count);
 		assert(slot.type != SLOT_EMPTY);
 
+		upgrade();
+
 		// Also remove the redirected tuple.
 		if (slot.type == SLOT_REDIRECT) {
 			TID* redirectTID = getData<TID>(slot);
@@ -129,21 +189,26 @@ namespace lsql {
 		// Reset this slot
 		slot.type = SLOT_EMPTY;
 		header->usedSpace -= slot.size;
+		setSlot(id.tuple(), slot);
+		linkFreeSlot(id.tuple());
 
-		// Remove all trailing empty slots
-		int16_t i = header->count - 1;
-		for (; i >= 0 && slots[i].type == SLOT_EMPTY; --i)
+		// Remove all trailing empty slots. The data start needs no update, as
+		// it never lies behind the data of any remaining slot.
+		for (int32_t i = header->count - 1; i >= 0 && getSlot(i).type == SLOT_EMPTY; --i) {
+			unlinkFreeSlot(i);
 			header->count--;
+		}
 
-		// Update dataStart according to the remaining slots
-		for (; i >= 0; --i)
-			if (slots[i].type != SLOT_EMPTY)
-				header->dataStart = std::min(header->dataStart, slots[i].offset);
+		recordFreeSpace();
 	}
 
 	int32_t SlottedPage::getFreeSpace() const {
-		int32_t headerSize = sizeof(Header) + (header->count + 1) * sizeof(Slot);
-		return int32_t(BufferFrame::SIZE) - header->usedSpace - headerSize;
+		int32_t headerSize = sizeof(Header) + (header->count + 1) * getSlotSize();
+		return size - header->usedSpace - headerSize;
+	}
+
+	void SlottedPage::recordFreeSpace() const {
+		segment->getFreeSpaceMap().update(pid.page(), FreeSpaceMap::getClass(getFreeSpace(), size));
 	}
 
 	SlottedPage::Iterator SlottedPage::begin() {
@@ -154,33 +219,100 @@ namespace lsql {
 		return Iterator(this, header->count);
 	}
 
+	void SlottedPage::upgrade() {
+		if (header->version != SLOTTED_PAGE_VERSION_LEGACY)
+			return;
+
+		// The field of the list head was padding, so it may contain garbage
+		header->firstFree = SLOTTED_PAGE_NO_SLOT;
+		header->version = SLOTTED_PAGE_VERSION_WIDE;
+
+		for (int32_t i = header->count - 1; i >= 0; --i)
+			if (getSlot(i).type == SLOT_EMPTY)
+				linkFreeSlot(i);
+	}
+
+	RecordView SlottedPage::view(const Slot& slot) const {
+		assert(slot.type == SLOT_USED);
+
+		segment->bufferManager.refixPage(*frame);
+		PageGuard guard(segment->bufferManager, *frame);
+		return RecordView(std::move(guard), getData(slot), uint32_t(slot.size));
+	}
+
+	void SlottedPage::linkFreeSlot(uint16_t id) {
+		Slot slot = getSlot(id);
+		assert(slot.type == SLOT_EMPTY);
+
+		slot.offset = header->firstFree;
+		slot.size = SLOTTED_PAGE_NO_SLOT;
+		setSlot(id, slot);
+
+		if (header->firstFree != SLOTTED_PAGE_NO_SLOT) {
+			Slot next = getSlot(header->firstFree);
+			next.size = id;
+			setSlot(header->firstFree, next);
+		}
+
+		header->firstFree = id;
+	}
+
+	void SlottedPage::unlinkFreeSlot(uint16_t id) {
+		Slot slot = getSlot(id);
+		assert(slot.type == SLOT_EMPTY);
+
+		uint16_t next = uint16_t(slot.offset);
+		uint16_t prev = uint16_t(slot.size);
+
+		if (prev != SLOTTED_PAGE_NO_SLOT) {
+			Slot prevSlot = getSlot(prev);
+			prevSlot.offset = next;
+			setSlot(prev, prevSlot);
+		} else {
+			header->firstFree = next;
+		}
+
+		if (next != SLOTTED_PAGE_NO_SLOT) {
+			Slot nextSlot = getSlot(next);
+			nextSlot.size = prev;
+			setSlot(next, nextSlot);
+		}
+	}
+
 	void SlottedPage::compressData() {
-		std::vector<Slot*> orderedSlots;
-		for (int16_t i = header->count - 1; i > 0; --i)
-			if (slots[i].type != SLOT_EMPTY)
-				orderedSlots.push_back(&slots[i]);
+		std::vector<std::pair<uint16_t, Slot>> orderedSlots;
+		for (int32_t i = header->count - 1; i >= 0; --i) {
+			Slot slot = getSlot(i);
+			if (slot.type != SLOT_EMPTY)
+				orderedSlots.emplace_back(uint16_t(i), slot);
+		}
 
 		// Order the slots after decreasing offsets
-		std::sort(orderedSlots.begin(), orderedSlots.end(), [] (Slot* a, Slot* b) {
-			return a->offset > b->offset;
+		std::sort(orderedSlots.begin(), orderedSlots.end(), [] (const std::pair<uint16_t, Slot>& a, const std::pair<uint16_t, Slot>& b) {
+			return a.second.offset > b.second.offset;
 		});
 
 		// Move all data to the back of the page.
-		header->dataStart = int32_t(BufferFrame::SIZE);
-		for (Slot* slot : orderedSlots) {
-			header->dataStart -= slot->size;
-			std::memmove(data + header->dataStart, data + slot->offset, slot->size);
-			slot->offset = header->dataStart;
+		int32_t dataStart = size;
+		for (auto& entry : orderedSlots) {
+			Slot& slot = entry.second;
+			dataStart -= slot.size;
+			std::memmove(data + dataStart, data + slot.offset, slot.size);
+			slot.offset = dataStart;
+			setSlot(entry.first, slot);
 		}
+
+		header->dataStart = dataStart;
 	}
 
-	void SlottedPage::replaceRecord(Slot& slot, const Record& record) {
+	void SlottedPage::replaceRecord(uint16_t id, Slot& slot, const Record& record) {
 		assert(slot.type != SLOT_EMPTY);
 		assert(int32_t(record.getSize()) <= slot.size);
 
 		header->usedSpace += record.getSize() - slot.size;
 		std::memcpy(getData(slot), record.getData(), record.getSize());
 		slot.size = record.getSize();
+		setSlot(id, slot);
 	}
 
-}
\ No newline at end of file
+}
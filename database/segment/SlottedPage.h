@@ -14,18 +14,42 @@
 #include "buffer/BufferFrame.h"
 #include "SPSegment.h"
 #include "Record.h"
+#include "RecordView.h"
+
+#define SLOTTED_PAGE_NO_SLOT UINT16_MAX
+
+#define SLOTTED_PAGE_VERSION_LEGACY 0
+#define SLOTTED_PAGE_VERSION_WIDE 1
+#define SLOTTED_PAGE_VERSION_PACKED 2
+
+#define SLOTTED_PAGE_PACKED_BITS 15
+#define SLOTTED_PAGE_PACKED_MASK ((1u << SLOTTED_PAGE_PACKED_BITS) - 1)
+#define SLOTTED_PAGE_PACKED_SIZE (SLOTTED_PAGE_PACKED_MASK + 1)
 
 namespace lsql {
 
 	/**
 	 * Represents a page within a slotted page segment.
+	 *
+	 * Pages of up to @c SLOTTED_PAGE_PACKED_SIZE bytes store each slot in four
+	 * bytes: two bits for the type and 15 bits each for offset and size.
+	 * Larger pages use wide slots of twelve bytes. The format is recorded as
+	 * version in the header. Pages written before versions were introduced
+	 * read as @c SLOTTED_PAGE_VERSION_LEGACY, which has wide slots but no list
+	 * of empty slots. They are upgraded to @c SLOTTED_PAGE_VERSION_WIDE when
+	 * their slots change for the first time.
 	 */
 	class SlottedPage {
 
-		/** Structure of the slotted page header. */
+		/**
+		 * Structure of the slotted page header. The version occupies the
+		 * upper byte of @c dataStart, which has always been zero before.
+		 */
 		struct Header {
 			uint16_t count;
-			int32_t dataStart;
+			uint16_t firstFree;
+			uint32_t dataStart : 24;
+			uint32_t version : 8;
 			int32_t usedSpace;
 		};
 
@@ -36,7 +60,12 @@ namespace lsql {
 			SLOT_REDIRECT
 		};
 
-		/** Structure of a slot within the slotted page. */
+		/**
+		 * Structure of a wide slot within the slotted page, which is also the
+		 * decoded form of packed slots. Empty slots are linked in a list
+		 * starting at @c Header::firstFree, where @c offset holds the next and
+		 * @c size the previous empty slot.
+		 */
 		struct Slot {
 			SlotType type;
 			int32_t offset;
@@ -44,11 +73,14 @@ namespace lsql {
 		};
 
 		SPSegment* segment;
+		BufferFrame* frame;
 
 		PID pid;
 		char* data;
+		int32_t size;
 		Header* header;
-		Slot* slots;
+		char* slots;
+		bool packed;
 
 	public:
 
@@ -80,12 +112,22 @@ namespace lsql {
 		 */
 		Record lookup(TID id) const;
 
+		/**
+		 * Searches an existing record within this page and returns a view of
+		 * its data instead of a copy. Redirects are followed, in which case
+		 * the guard is released and the target page is fixed instead.
+		 *
+		 * @param id    The tuple identifier of the record to find.
+		 * @param guard A guard holding this page in shared mode.
+		 */
+		RecordView lookupView(TID id, PageGuard&& guard) const;
+
 		/**
 		 * Creates a new slot within this page.
 		 *
-		 * Internally, this method will try to reuse previously freed slots as good
-		 * as possible. If there are no free slots to recycle, a new slot is appended
-		 * to the page.
+		 * Previously freed slots are taken from the list of empty slots in
+		 * constant time. If there are no free slots to recycle, a new slot is
+		 * appended to the page.
 		 *
 		 * @return The tuple identifier of the new slot.
 		 */
@@ -105,6 +147,21 @@ namespace lsql {
 		 */
 		void insert(TID id, const Record& record);
 
+		/**
+		 * Appends a record in a new slot behind all existing slots.
+		 *
+		 * Unlike @c createSlot and @c insert, this neither searches for free
+		 * slots nor compresses data, so it is meant for pages which are
+		 * filled from scratch by a bulk load. The free space of the page is
+		 * not recorded; call @c recordFreeSpace once the page is complete.
+		 *
+		 * @param record A record containing data to insert.
+		 * @param id     Receives the tuple identifier of the new record.
+		 *
+		 * @return True if the record fits into the page; otherwise false.
+		 */
+		bool append(const Record& record, TID& id);
+
 		/**
 		 * Updates the specified record with new data.
 		 *
@@ -131,9 +188,8 @@ namespace lsql {
 		 * Removes the specified record from this page.
 		 *
 		 * The corresponding slot is set to SLOT_EMPTY. If possible, this method
-		 * tries to clean up unused slots and thus shrink the header. Furthermore,
-		 * the dataStart pointer is updated, if necessary. In case the record entry
-		 * is a redirect, the redirected record is removed recursively.
+		 * tries to clean up unused slots and thus shrink the header. In case the
+		 * record entry is a redirect, the redirected record is removed recursively.
 		 *
 		 * This method fails if the slot specified by @c does not exist.
 		 *
@@ -146,6 +202,13 @@ namespace lsql {
 		 */
 		int32_t getFreeSpace() const;
 
+		/**
+		 * Records the free space of this page in the free space map of the
+		 * segment. The page must be latched in update or exclusive mode. All
+		 * modifying methods do this on their own.
+		 */
+		void recordFreeSpace() const;
+
 		/**
 		 * Returns an iterator to the first tuple in this page.
 		 */
@@ -158,6 +221,35 @@ namespace lsql {
 
 	private:
 
+		/**
+		 * Returns the size of a slot entry in bytes for the page format.
+		 */
+		size_t getSlotSize() const;
+
+		/**
+		 * Decodes a slot entry.
+		 *
+		 * @param id The number of the slot within this page.
+		 */
+		Slot getSlot(uint16_t id) const;
+
+		/**
+		 * Encodes a slot entry. Packed slots require offset and size of used
+		 * slots to fit into @c SLOTTED_PAGE_PACKED_BITS. Used slots without
+		 * data are stored with offset zero, as their offset may equal the
+		 * page size.
+		 *
+		 * @param id   The number of the slot within this page.
+		 * @param slot The decoded slot.
+		 */
+		void setSlot(uint16_t id, const Slot& slot);
+
+		/**
+		 * Builds the list of empty slots for pages in the legacy format and
+		 * marks them as wide pages. Other pages are left untouched.
+		 */
+		void upgrade();
+
 		/**
 		 * Returns a typed pointer to the data of a slot.
 		 *
@@ -167,7 +259,29 @@ namespace lsql {
 		 * @return A casted pointer to the slot data.
 		 */
 		template<typename DataType = char>
-		DataType* getData(Slot& slot) const;
+		DataType* getData(const Slot& slot) const;
+
+		/**
+		 * Returns a view of the data in a used slot, which fixes this page
+		 * once more. The page must be fixed in shared mode by the caller.
+		 *
+		 * @param slot The slot to create a view for.
+		 */
+		RecordView view(const Slot& slot) const;
+
+		/**
+		 * Adds an empty slot to the front of the list of empty slots.
+		 *
+		 * @param id The number of the slot within this page.
+		 */
+		void linkFreeSlot(uint16_t id);
+
+		/**
+		 * Removes an empty slot from the list of empty slots.
+		 *
+		 * @param id The number of the slot within this page.
+		 */
+		void unlinkFreeSlot(uint16_t id);
 
 		/**
 		 * Moves all data to the back of the page to maximize consecutive free space.
@@ -180,15 +294,63 @@ namespace lsql {
 		 * This only works, if the new data is less or equal than the current data.
 		 * Furthermore, slot and header counters are updated.
 		 *
-		 * @param slot   The slot to replace.
+		 * @param id     The number of the slot within this page.
+		 * @param slot   The slot to replace, which is written back.
 		 * @param record New data to replace the old one.
 		 */
-		void replaceRecord(Slot& slot, const Record& record);
+		void replaceRecord(uint16_t id, Slot& slot, const Record& record);
 
 	};
 
+	inline size_t SlottedPage::getSlotSize() const {
+		return packed ? sizeof(uint32_t) : sizeof(Slot);
+	}
+
+	inline SlottedPage::Slot SlottedPage::getSlot(uint16_t id) const {
+		if (!packed)
+			return reinterpret_cast<const Slot*>(slots)[id];
+
+		uint32_t value = reinterpret_cast<const uint32_t*>(slots)[id];
+
+		Slot slot;
+		slot.type = SlotType(value >> (2 * SLOTTED_PAGE_PACKED_BITS));
+		slot.offset = int32_t((value >> SLOTTED_PAGE_PACKED_BITS) & SLOTTED_PAGE_PACKED_MASK);
+		slot.size = int32_t(value & SLOTTED_PAGE_PACKED_MASK);
+
+		// Empty slots link other slots, where all bits set mean none
+		if (slot.type == SLOT_EMPTY) {
+			if (uint32_t(slot.offset) == SLOTTED_PAGE_PACKED_MASK)
+				slot.offset = SLOTTED_PAGE_NO_SLOT;
+			if (uint32_t(slot.size) == SLOTTED_PAGE_PACKED_MASK)
+				slot.size = SLOTTED_PAGE_NO_SLOT;
+		}
+
+		return slot;
+	}
+
+	inline void SlottedPage::setSlot(uint16_t id, const Slot& slot) {
+		if (!packed) {
+			reinterpret_cast<Slot*>(slots)[id] = slot;
+			return;
+		}
+
+		uint32_t offset = uint32_t(slot.offset);
+		uint32_t size = uint32_t(slot.size);
+		if (slot.type == SLOT_EMPTY) {
+			offset &= SLOTTED_PAGE_PACKED_MASK;
+			size &= SLOTTED_PAGE_PACKED_MASK;
+		} else if (size == 0) {
+			// Records without data may start at the end of the largest pages
+			offset = 0;
+		}
+
+		assert(offset <= SLOTTED_PAGE_PACKED_MASK && size <= SLOTTED_PAGE_PACKED_MASK);
+		reinterpret_cast<uint32_t*>(slots)[id] = (uint32_t(slot.type) << (2 * SLOTTED_PAGE_PACKED_BITS))
+			| (offset << SLOTTED_PAGE_PACKED_BITS) | size;
+	}
+
 	template<typename DataType>
-	DataType* SlottedPage::getData(Slot& slot) const {
+	DataType* SlottedPage::getData(const Slot& slot) const {
 		assert(slot.type != SLOT_EMPTY);
 		return reinterpret_cast<DataType*>(data + slot.offset);
 	}
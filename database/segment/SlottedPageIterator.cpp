@@ -14,28 +14,25 @@ namespace lsql {
 	typedef SlottedPage::Iterator SPI;
 
 	SPI::Iterator(SlottedPage* page, uint16_t start)
-	: page(page), slot(&page->slots[start]), record(nullptr) {
+	: page(page), slot(start) {
+		if (page != nullptr)
+			skipUnused();
 	}
 
 	SPI::Iterator(const SPI& iterator) {
 		*this = iterator;
 	}
 
-	SPI::~Iterator() {
-		if (record != nullptr)
-			delete record;
-	}
-
 	SPI& SPI::operator=(const SPI& iterator) {
 		page = iterator.page;
 		slot = iterator.slot;
-		record = nullptr;
+		view.release();
 
 		return *this;
 	}
 
 	bool SPI::operator==(const SPI& other) const {
-		return slot == other.slot;
+		return page == other.page && slot == other.slot;
 	}
 
 	bool SPI::operator!=(const SPI& other) const {
@@ -44,32 +41,33 @@ namespace lsql {
 
 	SPI& SPI::operator++() {
 		assert(page != nullptr);
-		assert(slot != nullptr);
 
-		if (record != nullptr)
-			delete record;
+		view.release();
 
-		do {
-			++slot;
-		} while (slot - page->slots < page->header->count && slot->type == SLOT_REDIRECT);
+		++slot;
+		skipUnused();
 
 		return *this;
 	}
 
-	Record& SPI::operator*() const {
+	const RecordView& SPI::operator*() const {
 		return *this->operator->();
 	}
 
-	Record* SPI::operator->() const {
+	const RecordView* SPI::operator->() const {
 		assert(page != nullptr);
-		assert(slot != nullptr);
-		assert(slot - page->slots < page->header->count);
+		assert(slot < page->header->count);
 
-		if (record == nullptr) {
-			const_cast<SPI*>(this)->record = new Record(slot->size, page->getData(*slot));
-		}
+		// Creating the view pins the page once more, but never allocates
+		if (view.getData() == nullptr)
+			const_cast<SPI*>(this)->view = page->view(page->getSlot(slot));
 
-		return record;
+		return &view;
+	}
+
+	void SPI::skipUnused() {
+		while (slot < page->header->count && page->getSlot(slot).type != SLOT_USED)
+			++slot;
 	}
 
-}
\ No newline at end of file
+}
@@ -8,19 +8,22 @@
 
 #pragma once
 
-#include "Record.h"
+#include "RecordView.h"
 #include "SlottedPage.h"
 
 namespace lsql {
 
 	/**
-	 *
+	 * Iterates over the records stored in a slotted page, skipping free slots
+	 * and redirects. Records are returned as views into the page, which keep
+	 * the page fixed while they are in use. The page must be fixed in shared
+	 * mode during the iteration.
 	 */
 	class SlottedPage::Iterator {
 
 		SlottedPage* page;
-		Slot* slot;
-		Record* record;
+		uint16_t slot;
+		RecordView view;
 
 	public:
 
@@ -34,11 +37,6 @@ namespace lsql {
 		 */
 		Iterator(const Iterator& iterator);
 
-		/**
-		 *
-		 */
-		~Iterator();
-
 		/**
 		 *
 		 */
@@ -62,12 +60,19 @@ namespace lsql {
 		/**
 		 *
 		 */
-		Record& operator*() const;
+		const RecordView& operator*() const;
 
 		/**
 		 *
 		 */
-		Record* operator->() const;
+		const RecordView* operator->() const;
+
+	private:
+
+		/**
+		 * Advances to the next used slot, starting at the current one.
+		 */
+		void skipUnused();
 
 	};
 
@@ -0,0 +1,125 @@
+//
+//  Bitmap.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+
+#include "Bitmap.h"
+
+namespace lsql {
+
+	Bitmap::Bitmap(uint64_t size)
+	: size(size) {
+		// Add levels until a single word summarizes everything
+		uint64_t bits = size > 0 ? size : 1;
+		do {
+			uint64_t count = (bits + 63) / 64;
+			std::atomic<uint64_t>* level = new std::atomic<uint64_t>[count];
+			for (uint64_t i = 0; i < count; ++i)
+				level[i].store(0, std::memory_order_relaxed);
+
+			levels.push_back(level);
+			words.push_back(count);
+			bits = count;
+		} while (bits > 1);
+	}
+
+	Bitmap::~Bitmap() {
+		for (std::atomic<uint64_t>* level : levels)
+			delete[] level;
+	}
+
+	uint64_t Bitmap::getSize() const {
+		return size;
+	}
+
+	bool Bitmap::get(uint64_t index) const {
+		assert(index < size);
+		return (levels[0][index / 64].load() >> (index % 64)) & 1;
+	}
+
+	void Bitmap::set(uint64_t index) {
+		assert(index < size);
+		set(0, index);
+	}
+
+	void Bitmap::clear(uint64_t index) {
+		assert(index < size);
+		clear(0, index);
+	}
+
+	uint64_t Bitmap::next(uint64_t start) const {
+		while (start < size) {
+			uint64_t index = start;
+			unsigned level = 0;
+
+			// Ascend until a level has a set bit at or after the index
+			bool found = false;
+			while (level < levels.size()) {
+				uint64_t word = index / 64;
+				if (word >= words[level])
+					return BITMAP_NONE;
+
+				uint64_t bits = levels[level][word].load() & (~uint64_t(0) << (index % 64));
+				if (bits != 0) {
+					index = word * 64 + __builtin_ctzll(bits);
+					found = true;
+					break;
+				}
+
+				index = word + 1;
+				++level;
+			}
+
+			if (!found)
+				return BITMAP_NONE;
+
+			// Descend to the first set bit below the summary bit
+			bool stale = false;
+			while (level > 0) {
+				--level;
+				uint64_t bits = levels[level][index].load();
+				if (bits == 0) {
+					stale = true;
+					break;
+				}
+				index = index * 64 + __builtin_ctzll(bits);
+			}
+
+			if (!stale)
+				return index;
+
+			// A concurrent update cleared the word, continue behind it
+			start = (index + 1) << (6 * (level + 1));
+		}
+
+		return BITMAP_NONE;
+	}
+
+	void Bitmap::set(unsigned level, uint64_t index) {
+		uint64_t bit = uint64_t(1) << (index % 64);
+		uint64_t previous = levels[level][index / 64].fetch_or(bit);
+
+		if (previous == 0 && level + 1 < levels.size())
+			set(level + 1, index / 64);
+	}
+
+	void Bitmap::clear(unsigned level, uint64_t index) {
+		std::atomic<uint64_t>& word = levels[level][index / 64];
+		uint64_t bit = uint64_t(1) << (index % 64);
+		uint64_t previous = word.fetch_and(~bit);
+
+		if (previous != bit || level + 1 == levels.size())
+			return;
+
+		// Restore the summary bit if another thread set a bit meanwhile
+		clear(level + 1, index / 64);
+		if (word.load() != 0)
+			set(level + 1, index / 64);
+	}
+
+}
@@ -0,0 +1,99 @@
+//
+//  Bitmap.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#define BITMAP_NONE UINT64_MAX
+
+namespace lsql {
+
+	/**
+	 * A fixed-size bitmap with summary levels, which finds the next set bit
+	 * in a number of steps logarithmic to base 64 in its size.
+	 *
+	 * Level zero holds one bit per element. Each bit of a higher level tells
+	 * whether the corresponding word of the level below has any bit set. Bits
+	 * may be set and cleared concurrently. A search running concurrently to
+	 * updates of the same word may miss a bit which is set meanwhile, which
+	 * is fine for users treating the bitmap as a hint.
+	 */
+	class Bitmap {
+
+		uint64_t size;
+		std::vector<std::atomic<uint64_t>*> levels;
+		std::vector<uint64_t> words;
+
+	public:
+
+		/**
+		 * Creates an empty bitmap.
+		 *
+		 * @param size The number of bits.
+		 */
+		explicit Bitmap(uint64_t size);
+
+		/** Prevent the copy constructor. */
+		Bitmap(const Bitmap& other) = delete;
+
+		/** Prevent copy assignments. */
+		Bitmap& operator=(const Bitmap& other) = delete;
+
+		/**
+		 * Releases all levels.
+		 */
+		~Bitmap();
+
+		/**
+		 * Returns the number of bits.
+		 */
+		uint64_t getSize() const;
+
+		/**
+		 * Returns whether a bit is set.
+		 */
+		bool get(uint64_t index) const;
+
+		/**
+		 * Sets a bit and marks it in the summary levels.
+		 */
+		void set(uint64_t index);
+
+		/**
+		 * Clears a bit and unmarks its words in the summary levels, if they
+		 * become empty.
+		 */
+		void clear(uint64_t index);
+
+		/**
+		 * Searches the first set bit at or after the given index.
+		 *
+		 * @param start The index to start at.
+		 *
+		 * @return The index of the bit or @c BITMAP_NONE.
+		 */
+		uint64_t next(uint64_t start) const;
+
+	private:
+
+		/**
+		 * Sets a bit at the given level and propagates it upwards.
+		 */
+		void set(unsigned level, uint64_t index);
+
+		/**
+		 * Clears a bit at the given level and propagates it upwards.
+		 */
+		void clear(unsigned level, uint64_t index);
+
+	};
+
+}
@@ -6,6 +6,8 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <cassert>
+
 #include "ConcurrentList.h"
 
 namespace lsql {
@@ -72,11 +74,13 @@ namespace lsql {
 	template<typename Item, typename AccessPolicy>
 	void ConcurrentList<Item, AccessPolicy>::bringFront(Item* item, bool l) {
 		assert(item != nullptr);
+		if (l) lock(true);
 
-		if (item == first)
+		// Check under the lock, as another thread might have moved the item
+		if (item == first) {
+			if (l) unlock();
 			return;
-
-		if (l) lock(true);
+		}
 
 		if (item == last)
 			last = prev(item);
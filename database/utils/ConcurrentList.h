@@ -10,7 +10,7 @@
 
 #include <atomic>
 
-#include "Lock.h"
+#include "Latch.h"
 
 namespace lsql {
 
@@ -19,7 +19,7 @@ namespace lsql {
 	 *
 	 * For performance reasons, list items are not owned by this list but 
 	 * managed externally. Concurrent access to the list is handled by a global 
-	 * read/write lock. Each non constant method tries to acquire an exclusive 
+	 * read/write latch. Each non constant method tries to acquire an exclusive 
 	 * lock. If the lock is held by another thread, the method call blocks until 
 	 * the lock is released by the other thread.
 	 *
@@ -44,7 +44,7 @@ namespace lsql {
 		using AccessPolicy::prev;
 		using AccessPolicy::next;
 
-		Lock l;
+		Latch l;
 		Item* first;
 		Item* last;
 		std::atomic<uint64_t> size;
@@ -0,0 +1,55 @@
+//
+//  Condition.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+#include <sys/time.h>
+
+#include "Condition.h"
+
+namespace lsql {
+
+	Condition::Condition() {
+		int rc = pthread_cond_init(&c, nullptr);
+		assert(rc == 0);
+	}
+
+	Condition::~Condition() {
+		int rc = pthread_cond_destroy(&c);
+		assert(rc == 0);
+	}
+
+	bool Condition::wait(Mutex& mutex) {
+		return pthread_cond_wait(&c, mutex.object()) == 0;
+	}
+
+	bool Condition::wait(Mutex& mutex, uint64_t timeout) {
+		timeval now;
+		gettimeofday(&now, nullptr);
+
+		// pthread_cond_timedwait expects an absolute time
+		uint64_t usec = uint64_t(now.tv_usec) + timeout;
+		timespec until;
+		until.tv_sec = now.tv_sec + time_t(usec / 1000000);
+		until.tv_nsec = long(usec % 1000000) * 1000;
+
+		return pthread_cond_timedwait(&c, mutex.object(), &until) == 0;
+	}
+
+	bool Condition::signal() {
+		return pthread_cond_signal(&c) == 0;
+	}
+
+	bool Condition::broadcast() {
+		return pthread_cond_broadcast(&c) == 0;
+	}
+
+	pthread_cond_t* Condition::object() {
+		return &c;
+	}
+
+}
@@ -0,0 +1,84 @@
+//
+//  Condition.h
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <pthread.h>
+
+#include "Mutex.h"
+
+namespace lsql {
+
+	/**
+	 * Wrapper class for condition variables.
+	 */
+	class Condition {
+
+		pthread_cond_t c;
+
+	public:
+
+		/**
+		 * Creates and initializes a new condition variable.
+		 */
+		Condition();
+
+		/**
+		 * Destroys this condition variable.
+		 *
+		 * This method might fail, if there are still threads waiting on it.
+		 */
+		~Condition();
+
+		/**
+		 * Blocks until the condition is signaled.
+		 *
+		 * The given mutex must be locked by the calling thread. It is released
+		 * while waiting and acquired again before this method returns. Since
+		 * wake ups may be spurious, the caller has to check its predicate again.
+		 *
+		 * @param mutex The mutex protecting the predicate.
+		 * @return True if the condition has been signaled; otherwise false.
+		 */
+		bool wait(Mutex& mutex);
+
+		/**
+		 * Blocks until the condition is signaled or the timeout has expired.
+		 * See @c Condition::wait for more information.
+		 *
+		 * @param mutex   The mutex protecting the predicate.
+		 * @param timeout The maximum time to wait in microseconds.
+		 * @return True if the condition has been signaled; false on timeout.
+		 */
+		bool wait(Mutex& mutex, uint64_t timeout);
+
+		/**
+		 * Wakes up at least one thread waiting on this condition.
+		 *
+		 * @return True if the condition could be signaled; otherwise false.
+		 */
+		bool signal();
+
+		/**
+		 * Wakes up all threads waiting on this condition.
+		 *
+		 * @return True if the condition could be signaled; otherwise false.
+		 */
+		bool broadcast();
+
+		/**
+		 * Retrieves a handle to the internal condition object.
+		 *
+		 * @return A pointer to the initialized pthread_cond.
+		 */
+		pthread_cond_t* object();
+
+	};
+
+}
@@ -7,10 +7,14 @@
 //
 
 #include <cassert>
+#include <cerrno>
+#include <climits>
 #include <cstdio>
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#include <algorithm>
 #include <iostream>
 
 #include "File.h"
@@ -18,16 +22,16 @@
 namespace lsql {
 
 	template<typename Element>
-	File<Element>::File() {
+	File<Element>::File() : direct(false) {
 		fd = fileno(tmpfile());
 	}
 
 	template<typename Element>
-	File<Element>::File(int fd) : fd(fd) {}
+	File<Element>::File(int fd) : fd(fd), direct(false) {}
 
 	template<typename Element>
-	File<Element>::File(const std::string& path, bool write) : fd(0), path(path) {
-		open(write);
+	File<Element>::File(const std::string& path, bool write, bool direct) : fd(0), path(path), direct(false) {
+		open(write, direct);
 	}
 
 	template<typename Element>
@@ -41,14 +45,39 @@ namespace lsql {
 	}
 
 	template<typename Element>
-	bool File<Element>::open(bool write) {
+	bool File<Element>::isDirect() const {
+		return direct;
+	}
+
+	template<typename Element>
+	bool File<Element>::open(bool write, bool direct) {
 		close();
 
-		if (write) {
-			fd = ::open(path.c_str(), O_CREAT|O_RDWR, S_IRUSR|S_IWUSR);
-		} else {
-			fd = ::open(path.c_str(), O_CREAT|O_RDONLY, S_IRUSR|S_IWUSR);
+		int flags = write ? O_CREAT|O_RDWR : O_CREAT|O_RDONLY;
+#ifdef O_DIRECT
+		if (direct)
+			flags |= O_DIRECT;
+#endif
+
+		fd = ::open(path.c_str(), flags, S_IRUSR|S_IWUSR);
+
+#ifdef O_DIRECT
+		// Some file systems, such as tmpfs, reject direct I/O
+		if (fd < 0 && direct && errno == EINVAL) {
+			std::cerr << "Direct I/O is not supported for file '" << path
+			          << "', using buffered I/O instead." << std::endl;
+			fd = ::open(path.c_str(), flags & ~O_DIRECT, S_IRUSR|S_IWUSR);
+			direct = false;
 		}
+#endif
+
+#ifdef F_NOCACHE
+		// Darwin has no O_DIRECT, but can disable caching per descriptor
+		if (fd > 0 && direct)
+			fcntl(fd, F_NOCACHE, 1);
+#endif
+
+		this->direct = direct;
 
 		if (fd <= 0) {
 			std::cerr << "Cannot open file '" << path << "' for "
@@ -82,6 +111,19 @@ namespace lsql {
 		return false;
 	}
 
+	template<typename Element>
+	off_t File<Element>::size() const {
+		assert(fd > 0);
+
+		struct stat info;
+		if (fstat(fd, &info) != 0) {
+			std::cerr << "Cannot read file size: " << strerror(errno) << std::endl;
+			return 0;
+		}
+
+		return info.st_size;
+	}
+
 	template<typename Element>
 	bool File<Element>::allocate(off_t elementCount) {
 		assert(fd > 0);
@@ -124,6 +166,7 @@ namespace lsql {
 		assert(fd > 0);
 		assert(size >= 0);
 		assert(offset >= 0);
+		assert(!direct || isAligned(data, size, offset));
 
 		ssize_t readSize = ::pread(fd, data, size, offset);
 		if (readSize < 0) {
@@ -139,6 +182,7 @@ namespace lsql {
 		assert(fd > 0);
 		assert(size >= 0);
 		assert(offset >= 0);
+		assert(!direct || isAligned(data, size, offset));
 
 		ssize_t writtenSize = ::pwrite(fd, data, size, offset);
 		if (writtenSize == size) {
@@ -149,4 +193,54 @@ namespace lsql {
 		}
 	}
 
+	template<typename Element>
+	bool File<Element>::writeGather(const void* const* buffers, int count, off_t size, off_t offset) {
+		assert(fd > 0);
+		assert(count >= 0);
+		assert(size > 0);
+		assert(offset >= 0);
+
+#ifdef IOV_MAX
+		const int maxBuffers = IOV_MAX;
+#else
+		const int maxBuffers = 16;
+#endif
+
+		struct iovec vectors[maxBuffers];
+		int written = 0;
+		off_t partial = 0;
+
+		while (written < count) {
+			// Resume after buffers which have been written in a previous call
+			int vectorCount = std::min(count - written, maxBuffers);
+			for (int i = 0; i < vectorCount; ++i) {
+				assert(!direct || isAligned(buffers[written + i], size, offset));
+				vectors[i].iov_base = const_cast<void*>(buffers[written + i]);
+				vectors[i].iov_len = size;
+			}
+
+			vectors[0].iov_base = static_cast<char*>(vectors[0].iov_base) + partial;
+			vectors[0].iov_len -= partial;
+
+			ssize_t writtenSize = ::pwritev(fd, vectors, vectorCount, offset + written * size + partial);
+			if (writtenSize <= 0) {
+				std::cerr << "Cannot write to file: " << strerror(errno) << std::endl;
+				return false;
+			}
+
+			partial += writtenSize;
+			written += partial / size;
+			partial %= size;
+		}
+
+		return true;
+	}
+
+	template<typename Element>
+	bool File<Element>::isAligned(const void* data, off_t size, off_t offset) {
+		return reinterpret_cast<uintptr_t>(data) % FILE_DIRECT_ALIGNMENT == 0
+		    && size % FILE_DIRECT_ALIGNMENT == 0
+		    && offset % FILE_DIRECT_ALIGNMENT == 0;
+	}
+
 }
@@ -13,6 +13,8 @@
 #include <vector>
 #include <string>
 
+#define FILE_DIRECT_ALIGNMENT 4096
+
 namespace lsql {
 	
 	/**
@@ -26,6 +28,7 @@ namespace lsql {
 	private:
 		int fd;
 		std::string path;
+		bool direct;
 		
 	public:
 		
@@ -49,10 +52,12 @@ namespace lsql {
 		 *
 		 * @param path  A fully qualified path to the file. The path
 		 *              must exist, but the file does not.
-		 * @param write Specifies whether to open the file in read
-		 *              or write mode.
+		 * @param write  Specifies whether to open the file in read
+		 *               or write mode.
+		 * @param direct Specifies whether to bypass the page cache of
+		 *               the operating system. See @c open.
 		 */
-		File(const std::string& path, bool write = false);
+		File(const std::string& path, bool write = false, bool direct = false);
 		
 		/**
 		 * Destructs this object. If the file is open, it will be
@@ -68,14 +73,27 @@ namespace lsql {
 		 */
 		int descriptor() const;
 		
+		/**
+		 * Returns whether the file bypasses the page cache of the
+		 * operating system.
+		 */
+		bool isDirect() const;
+
 		/**
 		 * Opens the file. If @c write is @c true and does not exist,
 		 * it will be created automatically.
 		 *
-		 * @param write Specifies whether to open the file in read or
-		 *              write mode.
+		 * In direct mode, reads and writes bypass the page cache of the
+		 * operating system. Then, all buffers, sizes and offsets must be
+		 * aligned to @c FILE_DIRECT_ALIGNMENT bytes. If the file system
+		 * does not support direct I/O, the file is opened in buffered
+		 * mode instead.
+		 *
+		 * @param write  Specifies whether to open the file in read or
+		 *               write mode.
+		 * @param direct Specifies whether to bypass the page cache.
 		 */
-		bool open(bool write);
+		bool open(bool write, bool direct = false);
 		
 		/**
 		 * Closes the file, if it is open in any mode.
@@ -88,6 +106,11 @@ namespace lsql {
 		 */
 		bool remove();
 		
+		/**
+		 * Returns the current size of the file in bytes.
+		 */
+		off_t size() const;
+
 		/**
 		 * Allocates enough space to fit the given amount of elements.
 		 *
@@ -133,6 +156,24 @@ namespace lsql {
 		 * @param offset Number of elements to skip in the file.
 		 */
 		bool write(const void* data, off_t size, off_t offset = 0);
+
+		/**
+		 * Writes several memory segments of equal length to a contiguous
+		 * range of the file with as few system calls as possible.
+		 *
+		 * @param buffers An array of pointers to the memory segments.
+		 * @param count   The number of memory segments.
+		 * @param size    The length of each memory segment.
+		 * @param offset  Number of bytes to skip in the file.
+		 */
+		bool writeGather(const void* const* buffers, int count, off_t size, off_t offset = 0);
+
+	private:
+
+		/**
+		 * Checks whether a buffer can be used for direct I/O.
+		 */
+		static bool isAligned(const void* data, off_t size, off_t offset);
 		
 	};
 	
@@ -0,0 +1,204 @@
+//
+//  Latch.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cassert>
+#include <climits>
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Latch.h"
+
+namespace lsql {
+
+	static_assert(sizeof(Latch) == 8, "Latch must fit into eight bytes");
+
+	static std::atomic<uint32_t> nextToken(1);
+
+	/**
+	 * Hints the processor that the thread is spinning.
+	 */
+	static inline void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__)
+		asm volatile("yield");
+#endif
+	}
+
+	/**
+	 * Blocks until the word no longer has the expected value, or until woken.
+	 */
+	static void park(std::atomic<uint32_t>& word, uint32_t expected) {
+#ifdef __linux__
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#else
+		(void) word;
+		(void) expected;
+		sched_yield();
+#endif
+	}
+
+	/**
+	 * Wakes up all threads parked on the word.
+	 */
+	static void unpark(std::atomic<uint32_t>& word) {
+#ifdef __linux__
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+		(void) word;
+#endif
+	}
+
+	/**
+	 * Moves the latch into a new state as soon as the transition allows it.
+	 * The transition computes the next state from the current one, and
+	 * returns false if the latch cannot be acquired yet.
+	 */
+	template<typename Transition>
+	static void acquire(std::atomic<uint32_t>& state, Transition transition) {
+		for (unsigned spins = 0; ; ++spins) {
+			uint32_t current = state.load(std::memory_order_relaxed);
+			uint32_t next;
+
+			if (transition(current, next)) {
+				if (state.compare_exchange_weak(current, next, std::memory_order_acquire, std::memory_order_relaxed))
+					return;
+				continue;
+			}
+
+			if (spins < LATCH_SPIN_COUNT) {
+				pause();
+				continue;
+			}
+
+			// Announce the parked thread, so that the next release wakes it
+			if (!(current & LATCH_PARKED) && !state.compare_exchange_weak(current, current | LATCH_PARKED, std::memory_order_relaxed))
+				continue;
+
+			park(state, current | LATCH_PARKED);
+		}
+	}
+
+	/**
+	 * Attempts a transition like @c acquire, but gives up instead of waiting.
+	 */
+	template<typename Transition>
+	static bool tryAcquire(std::atomic<uint32_t>& state, Transition transition) {
+		uint32_t current = state.load(std::memory_order_relaxed);
+		uint32_t next;
+
+		while (transition(current, next)) {
+			if (state.compare_exchange_weak(current, next, std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+		}
+
+		return false;
+	}
+
+	static bool shared(uint32_t current, uint32_t& next) {
+		next = current + 1;
+		return !(current & LATCH_EXCLUSIVE);
+	}
+
+	static bool exclusive(uint32_t current, uint32_t& next) {
+		next = (current & LATCH_PARKED) | LATCH_EXCLUSIVE;
+		return (current & ~LATCH_PARKED) == 0;
+	}
+
+	static bool update(uint32_t current, uint32_t& next) {
+		next = current | LATCH_UPDATE;
+		return !(current & (LATCH_EXCLUSIVE | LATCH_UPDATE));
+	}
+
+	static bool upgrade(uint32_t current, uint32_t& next) {
+		next = (current & LATCH_PARKED) | LATCH_EXCLUSIVE;
+		return (current & LATCH_READERS) == 0;
+	}
+
+	Latch::Latch() : state(0), owner(0) {
+	}
+
+	bool Latch::lock(bool exclusive) {
+		acquire(state, exclusive ? lsql::exclusive : shared);
+		return true;
+	}
+
+	bool Latch::tryLock(bool exclusive) {
+		return tryAcquire(state, exclusive ? lsql::exclusive : shared);
+	}
+
+	bool Latch::lockUpdate() {
+		acquire(state, update);
+		owner.store(getToken(), std::memory_order_relaxed);
+		return true;
+	}
+
+	bool Latch::tryLockUpdate() {
+		if (!tryAcquire(state, update))
+			return false;
+
+		owner.store(getToken(), std::memory_order_relaxed);
+		return true;
+	}
+
+	bool Latch::upgrade() {
+		assert(owner == getToken());
+
+		// No other thread can take the latch, so only readers have to leave
+		acquire(state, lsql::upgrade);
+		return true;
+	}
+
+	bool Latch::unlock() {
+		uint32_t current = state.load(std::memory_order_relaxed);
+
+		// Readers cannot hold the latch together with an exclusive holder
+		if (current & LATCH_EXCLUSIVE) {
+			owner.store(0, std::memory_order_relaxed);
+			wake(state.exchange(0, std::memory_order_release));
+			return true;
+		}
+
+		// The token is cleared before the update bit, so a reader never
+		// mistakes itself for the update holder.
+		if ((current & LATCH_UPDATE) && owner.load(std::memory_order_relaxed) == getToken()) {
+			owner.store(0, std::memory_order_relaxed);
+			wake(state.fetch_and(~(LATCH_UPDATE | LATCH_PARKED), std::memory_order_release));
+			return true;
+		}
+
+		// Only the last reader has to wake writers
+		uint32_t next;
+		do {
+			assert((current & LATCH_READERS) > 0);
+			next = current - 1;
+			if ((next & LATCH_READERS) == 0)
+				next &= ~LATCH_PARKED;
+		} while (!state.compare_exchange_weak(current, next, std::memory_order_release, std::memory_order_relaxed));
+
+		if (!(next & LATCH_PARKED))
+			wake(current);
+		return true;
+	}
+
+	uint32_t Latch::getToken() {
+		static thread_local uint32_t token = nextToken++;
+		return token;
+	}
+
+	void Latch::wake(uint32_t previous) {
+		if (previous & LATCH_PARKED)
+			unpark(state);
+	}
+
+}
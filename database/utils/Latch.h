@@ -0,0 +1,118 @@
+//
+//  Latch.h
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#define LATCH_SPIN_COUNT 64
+
+#define LATCH_EXCLUSIVE (uint32_t(1) << 31)
+#define LATCH_UPDATE    (uint32_t(1) << 30)
+#define LATCH_PARKED    (uint32_t(1) << 29)
+#define LATCH_READERS   (LATCH_PARKED - 1)
+
+namespace lsql {
+
+	/**
+	 * A compact reader/writer latch for short critical sections.
+	 *
+	 * The latch supports the same modes as @c Lock -- shared, update and
+	 * exclusive -- but only occupies eight bytes. A thread which cannot
+	 * acquire the latch spins for @c LATCH_SPIN_COUNT rounds first, and then
+	 * parks on a futex until the latch is released. On platforms without
+	 * futexes, it yields the processor instead.
+	 *
+	 * All state is kept in a single word: the exclusive and update bits, a
+	 * bit indicating parked threads, and the number of readers. The update
+	 * holder is identified by a per-thread token, so that @c unlock can tell
+	 * it apart from readers.
+	 */
+	class Latch {
+
+		std::atomic<uint32_t> state;
+		std::atomic<uint32_t> owner;
+
+	public:
+
+		/**
+		 * Creates an unlocked latch.
+		 */
+		Latch();
+
+		/** Prevent the copy constructor. */
+		Latch(const Latch& other) = delete;
+
+		/** Prevent copy assignments. */
+		Latch& operator=(const Latch& other) = delete;
+
+		/**
+		 * Acquires the latch, blocking while a conflicting latch is held.
+		 * Conflicts are:
+		 *  1. An exclusive latch, if @c exclusive is false.
+		 *  2. Any latch mode, if @c exclusive is true.
+		 *
+		 * @param exclusive Whether or not the latch should be exclusive.
+		 * @return Always true.
+		 */
+		bool lock(bool exclusive);
+
+		/**
+		 * Tries to acquire the latch without blocking. See @c lock.
+		 *
+		 * @param exclusive Whether or not the latch should be exclusive.
+		 * @return True if the latch has been acquired; otherwise false.
+		 */
+		bool tryLock(bool exclusive);
+
+		/**
+		 * Acquires the latch in update mode, blocking while another thread
+		 * holds an update or exclusive latch. See @c Lock::lockUpdate.
+		 *
+		 * @return Always true.
+		 */
+		bool lockUpdate();
+
+		/**
+		 * Tries to acquire the latch in update mode without blocking.
+		 *
+		 * @return True if the latch has been acquired; otherwise false.
+		 */
+		bool tryLockUpdate();
+
+		/**
+		 * Converts the update latch of this thread into an exclusive latch,
+		 * waiting for all readers to leave.
+		 *
+		 * @return Always true.
+		 */
+		bool upgrade();
+
+		/**
+		 * Releases the latch in whichever mode this thread holds it.
+		 *
+		 * @return Always true.
+		 */
+		bool unlock();
+
+	private:
+
+		/**
+		 * Returns the token identifying the calling thread.
+		 */
+		static uint32_t getToken();
+
+		/**
+		 * Wakes up all parked threads, if the previous state indicates any.
+		 */
+		void wake(uint32_t previous);
+
+	};
+
+}
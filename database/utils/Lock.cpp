@@ -11,34 +11,105 @@
 
 namespace lsql {
 
-	Lock::Lock() {
+	Lock::Lock() : updating(false) {
 		int rc = pthread_rwlock_init(&l, nullptr);
 		assert(rc == 0);
+
+		rc = pthread_mutex_init(&u, nullptr);
+		assert(rc == 0);
 	}
 
 	Lock::~Lock() {
 		int rc = pthread_rwlock_destroy(&l);
 		assert(rc == 0);
+
+		pthread_mutex_destroy(&u);
 	}
 
 	bool Lock::lock(bool exclusive) {
-		if (exclusive) {
-			return pthread_rwlock_wrlock(&l) == 0;
-		} else {
+		if (!exclusive)
 			return pthread_rwlock_rdlock(&l) == 0;
+
+		// Exclusive locks also take the update mutex, so that they cannot
+		// slip in while an update lock is being upgraded.
+		if (pthread_mutex_lock(&u) != 0)
+			return false;
+
+		if (pthread_rwlock_wrlock(&l) != 0) {
+			pthread_mutex_unlock(&u);
+			return false;
 		}
+
+		setUpdater();
+		return true;
 	}
 
 	bool Lock::tryLock(bool exclusive) {
-		if (exclusive) {
-			return pthread_rwlock_trywrlock(&l) == 0;
-		} else {
+		if (!exclusive)
 			return pthread_rwlock_tryrdlock(&l) == 0;
+
+		if (pthread_mutex_trylock(&u) != 0)
+			return false;
+
+		if (pthread_rwlock_trywrlock(&l) != 0) {
+			pthread_mutex_unlock(&u);
+			return false;
 		}
+
+		setUpdater();
+		return true;
+	}
+
+	bool Lock::lockUpdate() {
+		if (pthread_mutex_lock(&u) != 0)
+			return false;
+
+		if (pthread_rwlock_rdlock(&l) != 0) {
+			pthread_mutex_unlock(&u);
+			return false;
+		}
+
+		setUpdater();
+		return true;
+	}
+
+	bool Lock::tryLockUpdate() {
+		if (pthread_mutex_trylock(&u) != 0)
+			return false;
+
+		if (pthread_rwlock_tryrdlock(&l) != 0) {
+			pthread_mutex_unlock(&u);
+			return false;
+		}
+
+		setUpdater();
+		return true;
+	}
+
+	bool Lock::upgrade() {
+		assert(isUpdater());
+
+		// Only readers can enter while neither lock is held
+		return pthread_rwlock_unlock(&l) == 0 && pthread_rwlock_wrlock(&l) == 0;
 	}
 
 	bool Lock::unlock() {
-		return pthread_rwlock_unlock(&l) == 0;
+		if (!isUpdater())
+			return pthread_rwlock_unlock(&l) == 0;
+
+		updating = false;
+		bool success = pthread_rwlock_unlock(&l) == 0;
+		return pthread_mutex_unlock(&u) == 0 && success;
+	}
+
+	void Lock::setUpdater() {
+		updater = pthread_self();
+		updating = true;
+	}
+
+	bool Lock::isUpdater() const {
+		// Only the thread holding the update mutex can clear the flag
+		return updating && pthread_equal(updater, pthread_self());
 	}
 
 	pthread_rwlock_t* Lock::object() {
@@ -10,15 +10,25 @@
 
 #include <pthread.h>
 #include <algorithm>
+#include <atomic>
 
 namespace lsql {
 
 	/**
 	 * Wrapper class for read/write locks.
+	 *
+	 * Besides shared and exclusive locks, the lock supports an update mode.
+	 * An update lock is compatible with shared locks, but not with other
+	 * update or exclusive locks. Thus, a thread can read under an update lock
+	 * without blocking readers, and later upgrade it to an exclusive lock
+	 * without other writers intervening.
 	 */
 	class Lock {
 
 		pthread_rwlock_t l;
+		pthread_mutex_t u;
+		std::atomic<bool> updating;
+		std::atomic<pthread_t> updater;
 
 	public:
 
@@ -48,6 +58,35 @@ namespace lsql {
 		 */
 		bool lock(bool exclusive);
 
+		/**
+		 * Acquires the lock in update mode.
+		 *
+		 * If another thread currently holds an update or exclusive lock, this
+		 * function blocks until the other thread releases its lock. Shared
+		 * locks can still be acquired by other threads.
+		 *
+		 * @return True if the lock could be acquired; otherwise false.
+		 */
+		bool lockUpdate();
+
+		/**
+		 * Tries to acquire the lock in update mode. See @c lockUpdate.
+		 *
+		 * @return True if the lock could be acquired; otherwise false.
+		 */
+		bool tryLockUpdate();
+
+		/**
+		 * Converts an update lock held by this thread into an exclusive lock.
+		 *
+		 * This function blocks until all shared locks have been released. No
+		 * other thread can acquire an update or exclusive lock in between, so
+		 * data read under the update lock remains valid.
+		 *
+		 * @return True if the lock has been upgraded; otherwise false.
+		 */
+		bool upgrade();
+
 		/**
 		 * Tries to acquire the lock.
 		 *
@@ -66,7 +105,7 @@ namespace lsql {
 		 *
 		 * If this thread holds no more locks on the specified object, another 
 		 * waiting thread can acquire the lock. For more information, see @c 
-		 * pthread_rwlock_unlock().
+		 * pthread_rwlock_unlock(). This releases locks in any mode.
 		 *
 		 * @return True if the lock could be released; otherwise false.
 		 */
@@ -79,6 +118,18 @@ namespace lsql {
 		 */
 		pthread_rwlock_t* object();
 
+	private:
+
+		/**
+		 * Records the calling thread as holder of the update mutex.
+		 */
+		void setUpdater();
+
+		/**
+		 * Checks whether the calling thread holds an update or exclusive lock.
+		 */
+		bool isUpdater() const;
+
 	};
 
 }
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <chrono>
+#include <vector>
+
+#include "buffer/BufferManager.h"
+
+using namespace std;
+using namespace lsql;
+
+BufferManager* bm;
+vector<PID> trace;
+unsigned threadCount;
+
+const ReplacementType policies[] = {
+	REPLACEMENT_2Q,
+	REPLACEMENT_CLOCK,
+	REPLACEMENT_LRU_K,
+	REPLACEMENT_ARC
+};
+
+static void* replay(void *arg) {
+	// replay every n-th access, so that threads interleave like when recording
+	uintptr_t threadNum = reinterpret_cast<uintptr_t>(arg);
+
+	for (size_t i=threadNum; i<trace.size(); i+=threadCount) {
+		BufferFrame& bf = bm->fixPage(trace[i], false);
+		bm->unfixPage(bf, false);
+	}
+
+	return NULL;
+}
+
+int main(int argc, char** argv) {
+	if (argc!=3 && argc!=4) {
+		cerr << "usage: " << argv[0] << " <trace> <pagesInRAM> [threads]" << endl;
+		exit(1);
+	}
+
+	unsigned pagesInRAM = atoi(argv[2]);
+	threadCount = (argc==4) ? atoi(argv[3]) : 1;
+
+	if (!AccessTrace::load(argv[1], trace) || trace.empty()) {
+		cerr << "error: cannot read trace " << argv[1] << endl;
+		exit(1);
+	}
+
+	cout << trace.size() << " accesses, " << pagesInRAM << " frames, "
+	     << threadCount << " threads" << endl;
+
+	for (ReplacementType policy : policies) {
+		// disable read ahead and background writes to compare the policies only
+		BufferOptions options;
+		options.replacement = policy;
+		options.readAheadPages = 0;
+		options.flushRate = 0;
+		bm = new BufferManager(pagesInRAM, options);
+
+		pthread_t threads[threadCount];
+		auto start = chrono::steady_clock::now();
+
+		for (unsigned i=0; i<threadCount; i++)
+			pthread_create(&threads[i], NULL, replay, reinterpret_cast<void*>(i));
+		for (unsigned i=0; i<threadCount; i++)
+			pthread_join(threads[i], NULL);
+
+		chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+		double hitRatio = 100.0 * bm->getStats().getHitRatio();
+
+		cout << setw(6) << bm->getPolicyName() << ": "
+		     << fixed << setprecision(2) << hitRatio << "% hits, "
+		     << unsigned(trace.size() / elapsed.count()) << " fixes/s" << endl;
+
+		delete bm;
+	}
+
+	return 0;
+}
@@ -1,4 +1,7 @@
 #include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <string>
 #include <vector>
 #include <cassert>
 #include <cstring>
@@ -24,6 +27,17 @@ const unsigned maxInserts = 1000000ul;
 const unsigned maxDeletes = 10000ul;
 const unsigned maxUpdates = 10000ul;
 
+// Number of records loaded in bulk mode.
+const unsigned bulkRecords = 100000ul;
+
+// Number of small records and of removes with reinserts in slot mode.
+const unsigned slotRecords = 2000ul;
+const unsigned slotOperations = 100000ul;
+
+// Number of narrow rows and their size in bytes in density mode.
+const unsigned densityRecords = 1000000ul;
+const unsigned densityRowSize = 16;
+
 // Percentage of a page that can be used to store the payload.
 const double loadFactor = 0.8;
 
@@ -92,6 +106,120 @@ public:
 	}
 };
 
+// Loads the same records one by one and in bulk, and compares throughput.
+int runBulkLoad(BufferManager& bm, unsigned count) {
+	Random64 rnd;
+	vector<unsigned> choices;
+	vector<Record> records;
+	records.reserve(count);
+	for (unsigned i = 0; i < count; ++i) {
+		choices.push_back(rnd.next() % testData.size());
+		const string& s = testData[choices.back()];
+		records.emplace_back(s.size(), s.c_str());
+	}
+
+	SPSegment single(bm, 2, 0);
+	auto start = chrono::steady_clock::now();
+	for (const Record& record : records)
+		single.insert(record);
+	double singleTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	SPSegment bulk(bm, 3, 0);
+	start = chrono::steady_clock::now();
+	vector<TID> tids = bulk.insertBatch(records);
+	double bulkTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	for (unsigned i = 0; i < count; i += 97) {
+		const string& value = testData[choices[i]];
+		Record rec = bulk.lookup(tids[i]);
+		assert(rec.getSize() == value.size());
+		assert(memcmp(rec.getData(), value.c_str(), value.size()) == 0);
+	}
+
+	cout << "Inserted " << count << " records one by one: "
+	     << unsigned(count / singleTime) << " records/s" << endl;
+	cout << "Inserted " << count << " records in bulk:    "
+	     << unsigned(count / bulkTime) << " records/s" << endl;
+
+	cout << "Success!" << endl;
+	return 0;
+}
+
+// Removes and reinserts small records, so that inserts reuse free slots.
+int runSlotChurn(BufferManager& bm, unsigned count) {
+	Random64 rnd;
+	vector<TID> tids;
+	vector<uint64_t> keys;
+
+	SPSegment sp(bm, 4, 0);
+	for (uint64_t key = 0; key < slotRecords; ++key) {
+		tids.push_back(sp.insert(Record(sizeof(key), reinterpret_cast<const char*>(&key))));
+		keys.push_back(key);
+	}
+
+	auto start = chrono::steady_clock::now();
+	for (unsigned i = 0; i < count; ++i) {
+		size_t victim = rnd.next() % tids.size();
+		bool removed = sp.remove(tids[victim]);
+		assert(removed);
+		(void) removed;
+
+		uint64_t key = slotRecords + i;
+		tids[victim] = sp.insert(Record(sizeof(key), reinterpret_cast<const char*>(&key)));
+		keys[victim] = key;
+	}
+	double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	for (size_t i = 0; i < tids.size(); ++i) {
+		Record rec = sp.lookup(tids[i]);
+		assert(rec.getSize() == sizeof(uint64_t));
+		assert(memcmp(rec.getData(), &keys[i], sizeof(uint64_t)) == 0);
+	}
+
+	cout << "Removed and reinserted " << count << " records: "
+	     << unsigned(count / time) << " operations/s" << endl;
+
+	cout << "Success!" << endl;
+	return 0;
+}
+
+// Loads narrow rows, then reports how many fit into a page and scans them.
+int runDensity(BufferManager& bm, unsigned count) {
+	vector<Record> records;
+	records.reserve(count);
+	for (uint64_t i = 0; i < count; ++i) {
+		uint64_t row[densityRowSize / sizeof(uint64_t)] = {i, ~i};
+		records.emplace_back(densityRowSize, reinterpret_cast<const char*>(row));
+	}
+
+	SPSegment sp(bm, 5, 0);
+	vector<TID> tids = sp.insertBatch(records);
+	unsigned pages = tids.back().page() + 1;
+
+	uint64_t scanned = 0;
+	uint64_t checksum = 0;
+	auto start = chrono::steady_clock::now();
+	for (auto page = sp.begin(); page != sp.end(); ++page) {
+		for (auto tuple = page->begin(); tuple != page->end(); ++tuple) {
+			checksum += *reinterpret_cast<const uint64_t*>(tuple->getData());
+			++scanned;
+		}
+	}
+	double scanTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	assert(scanned == count);
+	assert(checksum == uint64_t(count) * (count - 1) / 2);
+	(void) checksum;
+
+	cout << "Stored " << count << " rows of " << densityRowSize << " bytes in "
+	     << pages << " pages: " << double(count) / pages << " rows/page" << endl;
+	cout << "Scanned " << scanned << " rows: "
+	     << unsigned(scanned / scanTime) << " rows/s" << endl;
+
+	cout << "Success!" << endl;
+	return 0;
+}
+
 int main(int argc, char** argv) {
 	// Check arguments.
 //	if (argc != 2) {
@@ -109,6 +237,18 @@ int main(int argc, char** argv) {
 	// Set up everything.
 	BufferManager bm(100);
 
+	// Usage: slottedtest bulk [records]
+	if (argc > 1 && string(argv[1]) == "bulk")
+		return runBulkLoad(bm, argc > 2 ? unsigned(atoi(argv[2])) : bulkRecords);
+
+	// Usage: slottedtest slots [operations]
+	if (argc > 1 && string(argv[1]) == "slots")
+		return runSlotChurn(bm, argc > 2 ? unsigned(atoi(argv[2])) : slotOperations);
+
+	// Usage: slottedtest density [records]
+	if (argc > 1 && string(argv[1]) == "density")
+		return runDensity(bm, argc > 2 ? unsigned(atoi(argv[2])) : densityRecords);
+
 	//ToDo: Create Schema Manager
 	//SchemaManager lookup
 	SPSegment sp(bm, 1, 0);
@@ -193,11 +333,19 @@ int main(int argc, char** argv) {
 		TID tid = p.first;
 		const string& value = testData[p.second];
 		unsigned len = value.size();
-		Record rec = sp.lookup(tid);
+		RecordView rec = sp.lookupView(tid);
 		assert(rec.getSize() == len);
 		assert(memcmp(rec.getData(), value.c_str(), len) == 0);
 	}
 
+	// Scan, which must return every record exactly once.
+	size_t scanned = 0;
+	for (auto page = sp.begin(); page != sp.end(); ++page)
+		for (auto tuple = page->begin(); tuple != page->end(); ++tuple)
+			++scanned;
+	assert(scanned == values.size());
+	(void) scanned;
+
 	std::cout << "Success!" << std::endl;
 	return 0;
 }
@@ -0,0 +1,113 @@
+//
+//  BTreeTest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <atomic>
+#include <cstdio>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "buffer/BufferManager.h"
+#include "index/BTree.h"
+
+#define TEST_BTREE_SEGMENT 912
+#define TEST_BTREE_KEYS 100000
+#define TEST_BTREE_READERS 4
+
+namespace lsql {
+namespace test {
+
+	struct BTreeTestComparator {
+		int compare(uint64_t a, uint64_t b) const {
+			return (b < a) - (a < b);
+		}
+	};
+
+	struct BTreeTest : public testing::Test {
+		typedef BTree<uint64_t, BTreeTestComparator> Tree;
+
+		BufferManager* bm;
+		Tree* tree;
+
+		std::atomic<uint64_t> inserted;
+		std::atomic<uint64_t> lookups;
+		std::atomic<uint64_t> misses;
+		std::atomic<bool> done;
+
+		virtual void SetUp() {
+			// Small pages split often and build a tree with several levels
+			size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+
+			BufferOptions options;
+			options.flushRate = 0;
+			options.readAheadPages = 0;
+			options.pools.push_back(PoolOptions{ pageSize, 1024 });
+
+			bm = new BufferManager(16, options);
+			bm->setPageSize(TEST_BTREE_SEGMENT, pageSize);
+			tree = new Tree(*bm, TEST_BTREE_SEGMENT);
+
+			inserted = lookups = misses = 0;
+			done = false;
+		}
+
+		virtual void TearDown() {
+			delete tree;
+			delete bm;
+			remove(std::to_string(TEST_BTREE_SEGMENT).c_str());
+		}
+
+		/**
+		 * Returns the i-th key inserted, spreading inserts over all leaves.
+		 */
+		static uint64_t getKey(uint64_t i) {
+			return (i * 7919) % TEST_BTREE_KEYS;
+		}
+	};
+
+	void* lookupInserted(void* arg) {
+		auto test = (BTreeTest*) arg;
+
+		for (uint64_t i = 0; !test->done; ++i) {
+			uint64_t count = test->inserted;
+			if (count == 0)
+				continue;
+
+			uint64_t key = BTreeTest::getKey(i * 31 % count);
+			if (test->tree->lookup(key) != TID(key + 1))
+				test->misses++;
+			test->lookups++;
+		}
+
+		return nullptr;
+	}
+
+	TEST_F(BTreeTest, LooksUpOptimisticallyDuringSplits) {
+		pthread_t readers[TEST_BTREE_READERS];
+		for (pthread_t& reader : readers)
+			pthread_create(&reader, nullptr, lookupInserted, this);
+
+		for (uint64_t i = 0; i < TEST_BTREE_KEYS; ++i) {
+			uint64_t key = getKey(i);
+			ASSERT_TRUE(tree->insert(key, TID(key + 1)));
+			inserted = i + 1;
+		}
+
+		done = true;
+		for (pthread_t& reader : readers)
+			pthread_join(reader, nullptr);
+
+		EXPECT_LT(0u, lookups.load());
+		EXPECT_EQ(0u, misses.load());
+		EXPECT_EQ(TEST_BTREE_KEYS, tree->getSize());
+
+		for (uint64_t key = 0; key < TEST_BTREE_KEYS; ++key)
+			EXPECT_EQ(TID(key + 1), tree->lookup(key));
+	}
+
+}
+}
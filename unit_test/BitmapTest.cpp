@@ -0,0 +1,52 @@
+//
+//  BitmapTest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "utils/Bitmap.h"
+
+namespace lsql {
+namespace test {
+
+	TEST(BitmapTest, InitializesEmpty) {
+		Bitmap bitmap(1000);
+		EXPECT_EQ(1000, bitmap.getSize());
+		EXPECT_FALSE(bitmap.get(0));
+		EXPECT_EQ(BITMAP_NONE, bitmap.next(0));
+	}
+
+	TEST(BitmapTest, FindsNextSetBit) {
+		Bitmap bitmap(1 << 20);
+		bitmap.set(5);
+		bitmap.set(70000);
+		bitmap.set((1 << 20) - 1);
+
+		EXPECT_EQ(5, bitmap.next(0));
+		EXPECT_EQ(5, bitmap.next(5));
+		EXPECT_EQ(70000, bitmap.next(6));
+		EXPECT_EQ((1 << 20) - 1, bitmap.next(70001));
+		EXPECT_EQ(BITMAP_NONE, bitmap.next(1 << 20));
+	}
+
+	TEST(BitmapTest, ClearsSummaries) {
+		Bitmap bitmap(1 << 20);
+		bitmap.set(64);
+		bitmap.set(65);
+		bitmap.set(500000);
+
+		bitmap.clear(64);
+		EXPECT_EQ(65, bitmap.next(0));
+
+		bitmap.clear(65);
+		EXPECT_FALSE(bitmap.get(65));
+		EXPECT_EQ(500000, bitmap.next(0));
+
+		bitmap.clear(500000);
+		EXPECT_EQ(BITMAP_NONE, bitmap.next(0));
+	}
+
+}
+}
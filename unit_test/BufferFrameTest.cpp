@@ -12,11 +12,12 @@ namespace lsql {
 namespace test {
 
 	struct BufferFrameTest : public testing::Test {
+		File<void> file;
 		BufferFrame* frame;
 		
 		virtual void SetUp() {
 			PID p(1,2);
-			frame = new BufferFrame(p);
+			frame = new BufferFrame(p, file);
 		}
 		
 		virtual void TearDown() {
@@ -32,5 +33,24 @@ namespace test {
 		EXPECT_FALSE(frame->isDirty()) << "";
 	}
 
+	TEST_F(BufferFrameTest, SharedLockKeepsVersion) {
+		uint64_t version = frame->getVersion();
+		frame->lock(false);
+		frame->unlock();
+
+		EXPECT_EQ(version, frame->getVersion());
+	}
+
+	TEST_F(BufferFrameTest, ExclusiveLockChangesVersion) {
+		uint64_t version = frame->getVersion();
+
+		frame->lock(true);
+		EXPECT_EQ(1, frame->getVersion() & 1) << "Version must be odd while locked";
+
+		frame->unlock();
+		EXPECT_EQ(0, frame->getVersion() & 1) << "Version must be even when unlocked";
+		EXPECT_NE(version, frame->getVersion());
+	}
+
 }
 }
@@ -6,11 +6,492 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <cstdio>
+#include <initializer_list>
+#include <pthread.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
 #include "buffer/BufferManager.h"
+#include "buffer/PageGuard.h"
+
+#define TEST_SEGMENT 900
+#define TEST_FLUSH_SEGMENT 901
+#define TEST_CHECKPOINT_SEGMENT 902
+#define TEST_MANIFEST_SEGMENT 903
+#define TEST_MAPPED_SEGMENT 904
+#define TEST_SMALL_SEGMENT 905
+#define TEST_LARGE_SEGMENT 906
+#define TEST_CONCURRENT_SEGMENT 907
+#define TEST_CONCURRENT_THREADS 4
+#define TEST_CONCURRENT_PAGES 8
+#define TEST_CONCURRENT_FIXES 1000
+#define TEST_READ_AHEAD_SEGMENT 908
+#define TEST_READ_AHEAD_PAGES 64
+#define TEST_READ_AHEAD_WINDOW 8
+#define TEST_MANIFEST "manifest"
 
 namespace lsql {
 namespace test {
 
+	/**
+	 * Runs a buffer manager without background writer and read ahead, unless
+	 * the test changes the options. The files of all segments passed to
+	 * @c start and the manifest are removed after the test.
+	 */
+	struct BufferManagerFixture : public testing::Test {
+		BufferOptions options;
+		BufferManager* bm;
+		std::vector<uint16_t> segments;
+
+		BufferManagerFixture() : bm(nullptr) {
+			options.flushRate = 0;
+			options.readAheadPages = 0;
+		}
+
+		virtual void TearDown() {
+			delete bm;
+			for (uint16_t segment : segments)
+				remove(std::to_string(segment).c_str());
+			if (!options.manifestFile.empty())
+				remove(options.manifestFile.c_str());
+		}
+
+		/**
+		 * Replaces the buffer manager with a new one using the current
+		 * options. The old one writes back its pages first.
+		 */
+		void start(uint64_t size, std::initializer_list<uint16_t> used = {}) {
+			delete bm;
+			bm = nullptr;
+
+			segments.insert(segments.end(), used);
+			bm = new BufferManager(size, options);
+		}
+	};
+
+	typedef BufferManagerFixture BufferManagerFlushTest;
+	typedef BufferManagerFixture BufferManagerMappedTest;
+	typedef BufferManagerFixture BufferManagerPoolTest;
+	typedef BufferManagerFixture BufferManagerConcurrencyTest;
+
+	struct BufferManagerTest : public BufferManagerFixture {
+		BufferFrame* fixed;
+
+		virtual void SetUp() {
+			options.stallTimeout = 1000;
+			start(1, { TEST_SEGMENT });
+			fixed = &bm->fixPage(PID(TEST_SEGMENT, 0), false);
+		}
+	};
+
+	void* unfixDelayed(void* arg) {
+		auto test = (BufferManagerTest*) arg;
+
+		usleep(10000);
+		test->bm->unfixPage(*test->fixed, false);
+		return nullptr;
+	}
+
+	TEST_F(BufferManagerTest, StallTimesOut) {
+		EXPECT_EQ(nullptr, bm->tryFixPage(PID(TEST_SEGMENT, 1), false, 1000));
+		const LatencyHistogram& stalls = bm->getStats().get(LATENCY_STALL);
+		EXPECT_EQ(1, stalls.count);
+		EXPECT_LE(1000000, stalls.sum);
+
+		bm->unfixPage(*fixed, false);
+	}
+
+	TEST_F(BufferManagerTest, StallThrowsOnFix) {
+		EXPECT_THROW(bm->fixPage(PID(TEST_SEGMENT, 1), false), BufferStallError);
+		EXPECT_THROW(bm->fixPageUpdate(PID(TEST_SEGMENT, 1)), BufferStallError);
+
+		// The buffer manager stays usable after the timeout
+		bm->unfixPage(*fixed, false);
+		bm->unfixPage(bm->fixPage(PID(TEST_SEGMENT, 1), false), false);
+	}
+
+	TEST_F(BufferManagerTest, StallWaitsForUnfix) {
+		pthread_t thread;
+		pthread_create(&thread, nullptr, unfixDelayed, this);
+
+		BufferFrame* frame = bm->tryFixPage(PID(TEST_SEGMENT, 1), false, 1000000);
+		ASSERT_NE(nullptr, frame);
+		EXPECT_EQ(PID(TEST_SEGMENT, 1), frame->getId());
+		EXPECT_EQ(1, bm->getStats().get(LATENCY_STALL).count);
+
+		bm->unfixPage(*frame, false);
+		pthread_join(thread, nullptr);
+	}
+
+	TEST_F(BufferManagerTest, GuardCopiesKeepPageFixed) {
+		PageGuard guard(*bm, *fixed);
+		PageGuard copy(guard);
+
+		guard.release();
+		EXPECT_EQ(nullptr, guard.getFrame());
+		EXPECT_EQ(nullptr, bm->tryFixPage(PID(TEST_SEGMENT, 1), false, 1000));
+
+		copy.release();
+		BufferFrame* frame = bm->tryFixPage(PID(TEST_SEGMENT, 1), false, 1000);
+		ASSERT_NE(nullptr, frame);
+		bm->unfixPage(*frame, false);
+	}
+
+
+	TEST_F(BufferManagerFlushTest, FlushesAdjacentPages) {
+		start(4, { TEST_FLUSH_SEGMENT });
+
+		for (uint32_t i = 0; i < 4; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_FLUSH_SEGMENT, 3 - i), true);
+			*static_cast<uint32_t*>(frame.getData()) = 3 - i;
+			bm->unfixPage(frame, true);
+		}
+
+		bm->flushSegment(TEST_FLUSH_SEGMENT);
+		EXPECT_EQ(4, bm->getStats().get(COUNTER_WRITES));
+		EXPECT_EQ(1, bm->getStats().get(LATENCY_SAVE).count);
+
+		File<void> file(std::to_string(TEST_FLUSH_SEGMENT));
+		ASSERT_EQ(off_t(4 * BufferFrame::SIZE), file.size());
+
+		for (uint32_t i = 0; i < 4; ++i) {
+			uint32_t value = 0;
+			file.read(&value, sizeof(value), i * BufferFrame::SIZE);
+			EXPECT_EQ(i, value);
+		}
+	}
+
+
+	TEST_F(BufferManagerFlushTest, WritesDirtyVictimsBeforeReuse) {
+		start(1, { TEST_FLUSH_SEGMENT });
+
+		BufferFrame& dirty = bm->fixPage(PID(TEST_FLUSH_SEGMENT, 0), true);
+		*static_cast<uint32_t*>(dirty.getData()) = 42;
+		bm->unfixPage(dirty, true);
+
+		BufferFrame& other = bm->fixPage(PID(TEST_FLUSH_SEGMENT, 1), false);
+		EXPECT_EQ(1, bm->getStats().get(COUNTER_WRITES));
+		EXPECT_EQ(1, bm->getStats().get(COUNTER_EVICTIONS));
+		bm->unfixPage(other, false);
+
+		BufferFrame& reloaded = bm->fixPage(PID(TEST_FLUSH_SEGMENT, 0), false);
+		EXPECT_EQ(42, *static_cast<uint32_t*>(reloaded.getData()));
+		bm->unfixPage(reloaded, false);
+	}
+
+
+	TEST_F(BufferManagerFlushTest, CleansColdPagesInBackground) {
+		options.flushRate = 1000;
+		options.cleanRatio = 0.5;
+		start(8, { TEST_FLUSH_SEGMENT });
+
+		for (uint32_t i = 0; i < 8; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_FLUSH_SEGMENT, i), true);
+			*static_cast<uint32_t*>(frame.getData()) = i;
+			bm->unfixPage(frame, true);
+		}
+
+		// Only the cold half of the queue is written, without a flush
+		for (int i = 0; i < 1000 && bm->getStats().get(COUNTER_BACKGROUND_WRITES) < 4; ++i)
+			usleep(1000);
+
+		usleep(5 * BUFFER_WRITER_INTERVAL);
+		EXPECT_EQ(4u, bm->getStats().get(COUNTER_BACKGROUND_WRITES));
+
+		File<void> file(std::to_string(TEST_FLUSH_SEGMENT));
+		ASSERT_EQ(off_t(4 * BufferFrame::SIZE), file.size());
+
+		for (uint32_t i = 0; i < 4; ++i) {
+			uint32_t value = ~0u;
+			file.read(&value, sizeof(value), i * BufferFrame::SIZE);
+			EXPECT_EQ(i, value);
+		}
+	}
+
+
+	TEST_F(BufferManagerFlushTest, CheckpointReportsWrittenBytes) {
+		options.flushThreads = 2;
+		start(4, { TEST_FLUSH_SEGMENT, TEST_CHECKPOINT_SEGMENT });
+
+		for (uint32_t i = 0; i < 4; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_FLUSH_SEGMENT + i % 2, i), true);
+			bm->unfixPage(frame, true);
+		}
+
+		FlushReport report = bm->checkpoint();
+		EXPECT_EQ(4, report.pages);
+		EXPECT_EQ(4 * BufferFrame::SIZE, report.bytes);
+		EXPECT_EQ(0, bm->checkpoint().pages);
+	}
+
+
+	TEST_F(BufferManagerFlushTest, WarmsUpFromManifest) {
+		options.manifestFile = TEST_MANIFEST;
+		start(4, { TEST_MANIFEST_SEGMENT });
+
+		for (uint32_t i = 0; i < 3; ++i)
+			bm->unfixPage(bm->fixPage(PID(TEST_MANIFEST_SEGMENT, i), true), true);
+
+		start(4);
+		bm->awaitWarmup();
+		EXPECT_EQ(3, bm->getStats().get(COUNTER_WARMUP));
+
+		bm->unfixPage(bm->fixPage(PID(TEST_MANIFEST_SEGMENT, 1), false), false);
+		EXPECT_EQ(0, bm->getStats().get(COUNTER_MISSES));
+	}
+
+	TEST_F(BufferManagerFlushTest, WarmsUpWithPageSizeOfManifest) {
+		size_t small = BufferFrame::SIZE / 2;
+
+		options.manifestFile = TEST_MANIFEST;
+		options.pools.push_back(PoolOptions{ small, 4 });
+		start(4, { TEST_SMALL_SEGMENT });
+
+		ASSERT_TRUE(bm->setPageSize(TEST_SMALL_SEGMENT, small));
+		for (uint32_t i = 0; i < 3; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_SMALL_SEGMENT, i), true);
+			*static_cast<uint32_t*>(frame.getData()) = i;
+			bm->unfixPage(frame, true);
+		}
+
+		// The catalog sets page sizes only after the warmup has started
+		start(4);
+		bm->awaitWarmup();
+		EXPECT_EQ(3, bm->getStats().get(COUNTER_WARMUP));
+		EXPECT_EQ(small, bm->getPageSize(TEST_SMALL_SEGMENT));
+		EXPECT_FALSE(bm->setPageSize(TEST_SMALL_SEGMENT, BufferFrame::SIZE));
+		EXPECT_TRUE(bm->setPageSize(TEST_SMALL_SEGMENT, small));
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_SMALL_SEGMENT, i), false);
+			EXPECT_EQ(small, frame.getSize());
+			EXPECT_EQ(i, *static_cast<uint32_t*>(frame.getData()));
+			bm->unfixPage(frame, false);
+		}
+		EXPECT_EQ(0, bm->getStats().get(COUNTER_MISSES));
+	}
+
+
+	TEST_F(BufferManagerMappedTest, WritesThroughMapping) {
+		options.mapped = true;
+		options.mappedPages = 64;
+		start(4, { TEST_MAPPED_SEGMENT });
+
+		for (uint32_t i = 0; i < 16; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_MAPPED_SEGMENT, i), true);
+			*static_cast<uint32_t*>(frame.getData()) = i;
+			bm->unfixPage(frame, true);
+		}
+
+		EXPECT_LT(0, bm->getStats().get(COUNTER_EVICTIONS));
+
+		options.mapped = false;
+		start(4);
+		for (uint32_t i = 0; i < 16; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_MAPPED_SEGMENT, i), false);
+			EXPECT_EQ(i, *static_cast<uint32_t*>(frame.getData()));
+			bm->unfixPage(frame, false);
+		}
+	}
+
+	TEST_F(BufferManagerMappedTest, ReadsDoNotGrowFile) {
+		options.mapped = true;
+		options.mappedPages = 64;
+		start(4, { TEST_MAPPED_SEGMENT });
+
+		BufferFrame& frame = bm->fixPage(PID(TEST_MAPPED_SEGMENT, 3), false);
+		EXPECT_EQ(0u, *static_cast<uint32_t*>(frame.getData()));
+		bm->unfixPage(frame, false);
+		EXPECT_EQ(off_t(0), File<void>(std::to_string(TEST_MAPPED_SEGMENT)).size());
+
+		// Writing grows the file, and the page reads from it afterwards
+		BufferFrame& written = bm->fixPage(PID(TEST_MAPPED_SEGMENT, 3), true);
+		*static_cast<uint32_t*>(written.getData()) = 3;
+		bm->unfixPage(written, true);
+		EXPECT_LT(off_t(3 * BufferFrame::SIZE), File<void>(std::to_string(TEST_MAPPED_SEGMENT)).size());
+
+		BufferFrame& read = bm->fixPage(PID(TEST_MAPPED_SEGMENT, 3), false);
+		EXPECT_EQ(3u, *static_cast<uint32_t*>(read.getData()));
+		bm->unfixPage(read, false);
+	}
+
+
+	TEST_F(BufferManagerPoolTest, UsesPageSizeOfSegment) {
+		size_t small = BufferFrame::SIZE / 2;
+		size_t large = BufferFrame::SIZE * 2;
+
+		options.pools.push_back(PoolOptions{ small, 2 });
+		options.pools.push_back(PoolOptions{ large, 2 });
+		start(2, { TEST_SMALL_SEGMENT, TEST_LARGE_SEGMENT });
+
+		EXPECT_FALSE(bm->setPageSize(TEST_SMALL_SEGMENT, BufferFrame::SIZE / 4));
+		EXPECT_TRUE(bm->setPageSize(TEST_SMALL_SEGMENT, small));
+		EXPECT_TRUE(bm->setPageSize(TEST_LARGE_SEGMENT, large));
+		EXPECT_EQ(small, bm->getPageSize(TEST_SMALL_SEGMENT));
+
+		// Each pool replaces its own pages only
+		for (uint32_t i = 0; i < 4; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_SMALL_SEGMENT, i), true);
+			EXPECT_EQ(small, frame.getSize());
+			bm->unfixPage(frame, true);
+		}
+
+		BufferFrame& frame = bm->fixPage(PID(TEST_LARGE_SEGMENT, 0), true);
+		EXPECT_EQ(large, frame.getSize());
+		bm->unfixPage(frame, true);
+
+		EXPECT_EQ(2, bm->getStats().get(COUNTER_EVICTIONS));
+		EXPECT_EQ(2 * small + large, bm->checkpoint().bytes);
+
+		EXPECT_EQ(off_t(4 * small), File<void>(std::to_string(TEST_SMALL_SEGMENT)).size());
+		EXPECT_EQ(off_t(large), File<void>(std::to_string(TEST_LARGE_SEGMENT)).size());
+	}
+
+
+	struct ConcurrentFixer {
+		BufferManager* bm;
+		uint32_t first;
+	};
+
+	/**
+	 * Each thread increments the counter on the shared page 0 and on its own
+	 * pages, which do not all fit into the buffer, and reads page 0 shared.
+	 */
+	void* fixConcurrently(void* arg) {
+		BufferManager* bm = static_cast<ConcurrentFixer*>(arg)->bm;
+		uint32_t first = static_cast<ConcurrentFixer*>(arg)->first;
+
+		uint64_t last = 0;
+		for (uint32_t i = 0; i < TEST_CONCURRENT_FIXES; ++i) {
+			BufferFrame& shared = bm->fixPage(PID(TEST_CONCURRENT_SEGMENT, 0), true);
+			++*static_cast<uint64_t*>(shared.getData());
+			bm->unfixPage(shared, true);
+
+			BufferFrame& own = bm->fixPage(PID(TEST_CONCURRENT_SEGMENT, first + i % TEST_CONCURRENT_PAGES), true);
+			++*static_cast<uint64_t*>(own.getData());
+			bm->unfixPage(own, true);
+
+			// The shared counter never goes back, even after eviction
+			BufferFrame& read = bm->fixPage(PID(TEST_CONCURRENT_SEGMENT, 0), false);
+			uint64_t value = *static_cast<uint64_t*>(read.getData());
+			bm->unfixPage(read, false);
+
+			EXPECT_LE(last, value);
+			last = value;
+		}
+
+		return nullptr;
+	}
+
+	TEST_F(BufferManagerConcurrencyTest, FixesPagesConcurrently) {
+		const uint32_t pages = 1 + TEST_CONCURRENT_THREADS * TEST_CONCURRENT_PAGES;
+		start(TEST_CONCURRENT_PAGES / 2, { TEST_CONCURRENT_SEGMENT });
+
+		// Pages which do not exist on disc are not zeroed
+		for (uint32_t i = 0; i < pages; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_CONCURRENT_SEGMENT, i), true);
+			*static_cast<uint64_t*>(frame.getData()) = 0;
+			bm->unfixPage(frame, true);
+		}
+
+		pthread_t threads[TEST_CONCURRENT_THREADS];
+		ConcurrentFixer fixers[TEST_CONCURRENT_THREADS];
+		for (uint32_t i = 0; i < TEST_CONCURRENT_THREADS; ++i) {
+			fixers[i] = ConcurrentFixer{ bm, 1 + i * TEST_CONCURRENT_PAGES };
+			pthread_create(&threads[i], nullptr, fixConcurrently, &fixers[i]);
+		}
+
+		for (pthread_t& thread : threads)
+			pthread_join(thread, nullptr);
+
+		EXPECT_LT(0u, bm->getStats().get(COUNTER_EVICTIONS));
+
+		for (uint32_t i = 0; i < pages; ++i) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_CONCURRENT_SEGMENT, i), false);
+			uint64_t expected = TEST_CONCURRENT_FIXES / TEST_CONCURRENT_PAGES;
+			if (i == 0)
+				expected = TEST_CONCURRENT_THREADS * TEST_CONCURRENT_FIXES;
+
+			EXPECT_EQ(expected, *static_cast<uint64_t*>(frame.getData()));
+			bm->unfixPage(frame, false);
+		}
+	}
+
+
+	struct BufferManagerReadAheadTest : public BufferManagerFixture {
+		virtual void SetUp() {
+			// Read ahead skips pages which do not exist on disc yet
+			start(TEST_READ_AHEAD_PAGES, { TEST_READ_AHEAD_SEGMENT });
+			for (uint32_t i = 0; i < TEST_READ_AHEAD_PAGES; ++i) {
+				BufferFrame& frame = bm->fixPage(PID(TEST_READ_AHEAD_SEGMENT, i), true);
+				*static_cast<uint32_t*>(frame.getData()) = i;
+				bm->unfixPage(frame, true);
+			}
+
+			options.readAheadPages = TEST_READ_AHEAD_WINDOW;
+			options.readAheadThreads = 1;
+			start(2 * TEST_READ_AHEAD_PAGES);
+		}
+
+		/** Fixes and checks the given page, and releases it again. */
+		void read(uint32_t page) {
+			BufferFrame& frame = bm->fixPage(PID(TEST_READ_AHEAD_SEGMENT, page), false);
+			EXPECT_EQ(page, *static_cast<uint32_t*>(frame.getData()));
+			bm->unfixPage(frame, false);
+		}
+
+		/** Waits up to a second until the I/O thread has loaded the pages. */
+		uint64_t waitForReadAhead(uint64_t count) {
+			for (int i = 0; i < 1000 && bm->getStats().get(COUNTER_READ_AHEAD) < count; ++i)
+				usleep(1000);
+
+			return bm->getStats().get(COUNTER_READ_AHEAD);
+		}
+	};
+
+	TEST_F(BufferManagerReadAheadTest, LoadsWindowsAheadOfScans) {
+		// A run of misses starts read ahead behind the current page
+		for (uint32_t i = 0; i <= BUFFER_READ_AHEAD_TRIGGER; ++i)
+			read(i);
+
+		EXPECT_EQ(BUFFER_READ_AHEAD_TRIGGER + 1, bm->getStats().get(COUNTER_MISSES));
+		ASSERT_EQ(TEST_READ_AHEAD_WINDOW, waitForReadAhead(TEST_READ_AHEAD_WINDOW));
+
+		// Its first page queues the next window, so the scan never misses
+		uint32_t first = BUFFER_READ_AHEAD_TRIGGER + 1;
+		read(first);
+		ASSERT_EQ(2 * TEST_READ_AHEAD_WINDOW, waitForReadAhead(2 * TEST_READ_AHEAD_WINDOW));
+
+		for (uint32_t i = first + 1; i < first + 2 * TEST_READ_AHEAD_WINDOW; ++i)
+			read(i);
+
+		EXPECT_EQ(BUFFER_READ_AHEAD_TRIGGER + 1, bm->getStats().get(COUNTER_MISSES));
+		EXPECT_EQ(2 * TEST_READ_AHEAD_WINDOW, bm->getStats().get(COUNTER_HITS));
+	}
+
+	TEST_F(BufferManagerReadAheadTest, IgnoresRandomAccess) {
+		for (uint32_t i = 0; i < TEST_READ_AHEAD_PAGES; i += 2)
+			read(i);
+
+		// Give a wrongly queued window the chance to show up
+		usleep(10000);
+		EXPECT_EQ(0u, bm->getStats().get(COUNTER_READ_AHEAD));
+		EXPECT_EQ(TEST_READ_AHEAD_PAGES / 2, bm->getStats().get(COUNTER_MISSES));
+	}
+
+	TEST_F(BufferManagerReadAheadTest, PrefetchesUpToEndOfSegment) {
+		uint32_t first = TEST_READ_AHEAD_PAGES - TEST_READ_AHEAD_WINDOW / 2;
+		bm->prefetch(PID(TEST_READ_AHEAD_SEGMENT, first), TEST_READ_AHEAD_WINDOW);
+		EXPECT_EQ(TEST_READ_AHEAD_WINDOW / 2, waitForReadAhead(TEST_READ_AHEAD_WINDOW / 2));
+
+		for (uint32_t i = first; i < TEST_READ_AHEAD_PAGES; ++i)
+			read(i);
+
+		EXPECT_EQ(0u, bm->getStats().get(COUNTER_MISSES));
+		EXPECT_EQ(TEST_READ_AHEAD_WINDOW / 2, bm->getStats().get(COUNTER_READ_AHEAD));
+	}
 
 }
 }
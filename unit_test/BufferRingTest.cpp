@@ -0,0 +1,41 @@
+//
+//  BufferRingTest.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "buffer/BufferRing.h"
+
+namespace lsql {
+namespace test {
+
+	TEST(BufferRingTest, FillsBeforeDisplacing) {
+		BufferRing ring(3);
+		PID displaced(0);
+
+		EXPECT_FALSE(ring.add(PID(1, 0), displaced));
+		EXPECT_FALSE(ring.add(PID(1, 1), displaced));
+		EXPECT_FALSE(ring.add(PID(1, 2), displaced));
+	}
+
+	TEST(BufferRingTest, DisplacesOldestPage) {
+		BufferRing ring(2);
+		PID displaced(0);
+
+		ring.add(PID(1, 0), displaced);
+		ring.add(PID(1, 1), displaced);
+
+		EXPECT_TRUE(ring.add(PID(1, 2), displaced));
+		EXPECT_EQ(PID(1, 0), displaced);
+
+		EXPECT_TRUE(ring.add(PID(1, 3), displaced));
+		EXPECT_EQ(PID(1, 1), displaced);
+
+		EXPECT_TRUE(ring.add(PID(1, 4), displaced));
+		EXPECT_EQ(PID(1, 2), displaced);
+	}
+
+}
+}
@@ -0,0 +1,66 @@
+//
+//  BufferStatsTest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <pthread.h>
+
+#include "buffer/BufferStats.h"
+
+namespace lsql {
+namespace test {
+
+	void* countHits(void* arg) {
+		auto stats = (BufferStats*) arg;
+
+		for (int i = 0; i < 1000; ++i)
+			stats->count(COUNTER_HITS);
+
+		return nullptr;
+	}
+
+	TEST(BufferStatsTest, SumsAllThreads) {
+		BufferStats stats;
+		pthread_t threads[4];
+
+		for (pthread_t& thread : threads)
+			pthread_create(&thread, nullptr, countHits, &stats);
+		for (pthread_t& thread : threads)
+			pthread_join(thread, nullptr);
+
+		stats.count(COUNTER_MISSES, 4000);
+
+		BufferStats::Snapshot snapshot = stats.snapshot();
+		EXPECT_EQ(4000, snapshot.get(COUNTER_HITS));
+		EXPECT_DOUBLE_EQ(0.5, snapshot.getHitRatio());
+	}
+
+	TEST(BufferStatsTest, RecordsPercentiles) {
+		BufferStats stats;
+		for (int i = 0; i < 99; ++i)
+			stats.record(LATENCY_LOAD, 100);
+		stats.record(LATENCY_LOAD, 100000);
+
+		const LatencyHistogram& histogram = stats.snapshot().get(LATENCY_LOAD);
+		EXPECT_EQ(100, histogram.count);
+		EXPECT_DOUBLE_EQ(1099, histogram.getMean());
+		EXPECT_EQ(128, histogram.getPercentile(0.5));
+		EXPECT_EQ(131072, histogram.getPercentile(0.999));
+	}
+
+	TEST(BufferStatsTest, ResetsToZero) {
+		BufferStats stats;
+		stats.count(COUNTER_EVICTIONS);
+		stats.record(LATENCY_SAVE, 1000);
+		stats.reset();
+
+		BufferStats::Snapshot snapshot = stats.snapshot();
+		EXPECT_EQ(0, snapshot.get(COUNTER_EVICTIONS));
+		EXPECT_EQ(0, snapshot.get(LATENCY_SAVE).count);
+	}
+
+}
+}
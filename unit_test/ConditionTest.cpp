@@ -0,0 +1,63 @@
+//
+//  ConditionTest.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "helpers/ThreadHelpers.cpp"
+#include "utils/Condition.h"
+
+namespace lsql {
+namespace test {
+
+	struct ConditionTest : public testing::Test {
+		Mutex* m;
+		Condition* c;
+		bool signaled;
+
+		virtual void SetUp() {
+			m = new Mutex();
+			c = new Condition();
+			signaled = false;
+		}
+
+		virtual void TearDown() {
+			delete c;
+			delete m;
+		}
+	};
+
+	void* testSignal(void* arg) {
+		auto test = (ConditionTest*) arg;
+
+		test->m->lock();
+		test->signaled = true;
+		test->c->signal();
+		test->m->unlock();
+
+		return nullptr;
+	}
+
+	TEST_F(ConditionTest, TimesOut) {
+		m->lock();
+		EXPECT_FALSE(c->wait(*m, 1000));
+		m->unlock();
+	}
+
+	TEST_F(ConditionTest, WakesUp) {
+		pthread_t thread;
+
+		m->lock();
+		pthread_create(&thread, nullptr, &testSignal, this);
+		while (!signaled)
+			c->wait(*m);
+		m->unlock();
+
+		pthread_join(thread, nullptr);
+		EXPECT_TRUE(signaled);
+	}
+
+}
+}
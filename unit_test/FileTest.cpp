@@ -7,3 +7,26 @@
 //
 
 #include "utils/File.h"
+
+#include <cstdlib>
+
+namespace lsql {
+namespace test {
+
+	TEST(FileTest, DirectModeReadsWrittenData) {
+		void* written = valloc(FILE_DIRECT_ALIGNMENT);
+		void* read = valloc(FILE_DIRECT_ALIGNMENT);
+		memset(written, 42, FILE_DIRECT_ALIGNMENT);
+
+		File<void> file("direct", true, true);
+		ASSERT_TRUE(file.write(written, FILE_DIRECT_ALIGNMENT, FILE_DIRECT_ALIGNMENT));
+		EXPECT_EQ(FILE_DIRECT_ALIGNMENT, file.read(read, FILE_DIRECT_ALIGNMENT, FILE_DIRECT_ALIGNMENT));
+		EXPECT_EQ(0, memcmp(written, read, FILE_DIRECT_ALIGNMENT));
+
+		file.remove();
+		free(written);
+		free(read);
+	}
+
+}
+}
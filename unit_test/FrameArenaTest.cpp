@@ -0,0 +1,42 @@
+//
+//  FrameArenaTest.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <unistd.h>
+
+#include "buffer/FrameArena.h"
+
+namespace lsql {
+namespace test {
+
+	TEST(FrameArenaTest, FramesAreContiguousAndAligned) {
+		FrameArena arena(16, false);
+		ASSERT_EQ(16u, arena.getCount());
+
+		char* base = static_cast<char*>(arena.getFrame(0).getData());
+		EXPECT_EQ(0u, uintptr_t(base) % sysconf(_SC_PAGESIZE));
+
+		for (uint64_t i = 0; i < arena.getCount(); ++i)
+			EXPECT_EQ(base + i * BufferFrame::SIZE, arena.getFrame(i).getData());
+	}
+
+	TEST(FrameArenaTest, ResetReusesFrame) {
+		FrameArena arena(1, true);
+		File<void> file;
+		BufferFrame& frame = arena.getFrame(0);
+		void* data = frame.getData();
+
+		frame.reset(PID(1, 0), file);
+		EXPECT_EQ(PID(1, 0), frame.getId());
+
+		frame.reset(PID(1, 1), file);
+		EXPECT_EQ(PID(1, 1), frame.getId());
+		EXPECT_EQ(data, frame.getData());
+	}
+
+}
+}
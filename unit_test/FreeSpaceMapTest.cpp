@@ -0,0 +1,107 @@
+//
+//  FreeSpaceMapTest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cstdio>
+#include <string>
+
+#include "segment/FreeSpaceMap.h"
+
+#define TEST_FREE_SPACE_SEGMENT 910
+#define TEST_FREE_SPACE_PAGE_SIZE 4096
+
+namespace lsql {
+namespace test {
+
+	struct FreeSpaceMapTest : public testing::Test {
+		virtual void TearDown() {
+			remove((std::to_string(TEST_FREE_SPACE_SEGMENT) + ".fsm").c_str());
+		}
+	};
+
+	TEST_F(FreeSpaceMapTest, ClassesNeverOverstate) {
+		for (int32_t space = 0; space <= TEST_FREE_SPACE_PAGE_SIZE; space += 64) {
+			uint8_t spaceClass = FreeSpaceMap::getClass(space, TEST_FREE_SPACE_PAGE_SIZE);
+			EXPECT_LE(spaceClass * TEST_FREE_SPACE_PAGE_SIZE / FREE_SPACE_STEPS, space);
+
+			// A record fits into every page of the required class
+			uint8_t required = FreeSpaceMap::getRequiredClass(space, TEST_FREE_SPACE_PAGE_SIZE);
+			if (required < FREE_SPACE_CLASSES - 1) {
+				EXPECT_GE(required * TEST_FREE_SPACE_PAGE_SIZE / FREE_SPACE_STEPS, space);
+			}
+		}
+	}
+
+	TEST_F(FreeSpaceMapTest, FindsPagesWithSpace) {
+		FreeSpaceMap map(TEST_FREE_SPACE_SEGMENT);
+		for (uint32_t page = 0; page < 8; ++page)
+			map.update(page, 0);
+		map.update(5, 4);
+
+		EXPECT_EQ(5, map.find(2, 8));
+		EXPECT_EQ(FREE_SPACE_NO_PAGE, map.find(6, 8));
+		EXPECT_EQ(FREE_SPACE_NO_PAGE, map.find(3, 8, 5));
+
+		// Pages without an entry might have space
+		EXPECT_EQ(8, map.find(5, 9));
+	}
+
+	TEST_F(FreeSpaceMapTest, OffersPagesOfClassBelow) {
+		FreeSpaceMap map(TEST_FREE_SPACE_SEGMENT);
+		for (uint32_t page = 0; page < 4; ++page)
+			map.update(page, 0);
+
+		// A small record might fit into a page with less than a step free
+		uint8_t required = FreeSpaceMap::getRequiredClass(16, TEST_FREE_SPACE_PAGE_SIZE);
+		EXPECT_EQ(1, required);
+
+		// Such pages are offered in turn, as each might be too full
+		EXPECT_EQ(0, map.find(required, 4));
+		EXPECT_EQ(1, map.find(required, 4));
+		EXPECT_EQ(3, map.find(required, 4, 2));
+		EXPECT_EQ(FREE_SPACE_NO_PAGE, map.find(required + 1, 4));
+
+		map.update(2, 3);
+		EXPECT_EQ(2, map.find(4, 4));
+		EXPECT_EQ(FREE_SPACE_NO_PAGE, map.find(5, 4));
+	}
+
+	TEST_F(FreeSpaceMapTest, FindsSparsePagesInLargeSegments) {
+		const uint32_t pageCount = 1 << 20;
+		FreeSpaceMap map(TEST_FREE_SPACE_SEGMENT, pageCount);
+		map.update(123456, 9);
+		map.update(pageCount - 1, 12);
+
+		// Known pages are preferred over the unknown ones
+		EXPECT_EQ(123456, map.find(9, pageCount));
+		EXPECT_EQ(pageCount - 1, map.find(9, pageCount, 123456));
+		EXPECT_EQ(pageCount - 1, map.find(10, pageCount));
+	}
+
+	TEST_F(FreeSpaceMapTest, GrowsWithSegment) {
+		FreeSpaceMap map(TEST_FREE_SPACE_SEGMENT);
+		map.update(200000, 3);
+		map.update(5, 0);
+
+		EXPECT_EQ(200000, map.find(3, 200001));
+	}
+
+	TEST_F(FreeSpaceMapTest, PersistsEntries) {
+		FreeSpaceMap* map = new FreeSpaceMap(TEST_FREE_SPACE_SEGMENT);
+		for (uint32_t page = 0; page < 4; ++page)
+			map->update(page, 0);
+		map->update(2, 7);
+		delete map;
+
+		map = new FreeSpaceMap(TEST_FREE_SPACE_SEGMENT);
+		EXPECT_EQ(2, map->find(7, 4));
+		EXPECT_EQ(FREE_SPACE_NO_PAGE, map->find(7, 4, 2));
+		delete map;
+	}
+
+}
+}
@@ -6,8 +6,15 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <chrono>
+#include <iostream>
+
 #include "helpers/ThreadHelpers.cpp"
 #include "utils/Lock.h"
+#include "utils/Latch.h"
+
+#define LOCK_BENCHMARK_THREADS 4
+#define LOCK_BENCHMARK_OPS 200000
 
 using namespace lsql;
 
@@ -52,5 +59,237 @@ namespace test {
 		EXPECT_EQ(0, testThreadded(&testUnlocked, (void*) l->object()));
 	}
 
+
+	void* testUpdateLock(void* arg) {
+		auto lock = (Lock*) arg;
+		ssize_t rc = 0;
+
+		if (lock->tryLockUpdate() || lock->tryLock(true))
+			rc = 1;
+		if (!lock->tryLock(false))
+			rc = 2;
+		else
+			lock->unlock();
+
+		return (void*) rc;
+	}
+
+	TEST_F(LockTest, LocksUpdate) {
+		l->lockUpdate();
+		EXPECT_EQ(0, testThreadded(&testUpdateLock, (void*) l));
+		l->unlock();
+	}
+
+	TEST_F(LockTest, UpgradesUpdate) {
+		l->lockUpdate();
+		l->upgrade();
+		EXPECT_EQ(0, testThreadded(&testExclusiveLock, (void*) l->object()));
+		l->unlock();
+	}
+
+	TEST_F(LockTest, UnlocksUpdate) {
+		l->lockUpdate();
+		l->unlock();
+		EXPECT_EQ(0, testThreadded(&testUnlocked, (void*) l->object()));
+		EXPECT_TRUE(l->tryLockUpdate());
+		l->unlock();
+	}
+
+
+	struct LatchTest : public testing::Test {
+		Latch* l;
+
+		virtual void SetUp() {
+			l = new Latch();
+		}
+
+		virtual void TearDown() {
+			delete l;
+		}
+	};
+
+	void* testSharedLatch(void* arg) {
+		auto latch = (Latch*) arg;
+		ssize_t rc = 0;
+
+		if (latch->tryLock(true))
+			rc = 1;
+		if (!latch->tryLock(false))
+			rc = 2;
+		else
+			latch->unlock();
+
+		return (void*) rc;
+	}
+
+	void* testExclusiveLatch(void* arg) {
+		auto latch = (Latch*) arg;
+		ssize_t rc = 0;
+
+		if (latch->tryLock(false) || latch->tryLockUpdate())
+			rc = 1;
+
+		return (void*) rc;
+	}
+
+	void* testUpdateLatch(void* arg) {
+		auto latch = (Latch*) arg;
+		ssize_t rc = 0;
+
+		if (latch->tryLockUpdate() || latch->tryLock(true))
+			rc = 1;
+		if (!latch->tryLock(false))
+			rc = 2;
+		else
+			latch->unlock();
+
+		return (void*) rc;
+	}
+
+	void* testUnlockedLatch(void* arg) {
+		auto latch = (Latch*) arg;
+		ssize_t rc = 0;
+
+		if (!latch->tryLock(true))
+			rc = 1;
+		else
+			latch->unlock();
+
+		return (void*) rc;
+	}
+
+	TEST_F(LatchTest, FitsEightBytes) {
+		EXPECT_EQ(8, sizeof(Latch));
+	}
+
+	TEST_F(LatchTest, LocksShared) {
+		l->lock(false);
+		EXPECT_EQ(0, testThreadded(&testSharedLatch, (void*) l));
+		l->unlock();
+		EXPECT_EQ(0, testThreadded(&testUnlockedLatch, (void*) l));
+	}
+
+	TEST_F(LatchTest, LocksExclusive) {
+		l->lock(true);
+		EXPECT_EQ(0, testThreadded(&testExclusiveLatch, (void*) l));
+		l->unlock();
+		EXPECT_EQ(0, testThreadded(&testUnlockedLatch, (void*) l));
+	}
+
+	TEST_F(LatchTest, LocksUpdate) {
+		l->lockUpdate();
+		EXPECT_EQ(0, testThreadded(&testUpdateLatch, (void*) l));
+		l->unlock();
+		EXPECT_EQ(0, testThreadded(&testUnlockedLatch, (void*) l));
+	}
+
+	TEST_F(LatchTest, UpgradesUpdate) {
+		l->lockUpdate();
+		l->upgrade();
+		EXPECT_EQ(0, testThreadded(&testExclusiveLatch, (void*) l));
+		l->unlock();
+		EXPECT_EQ(0, testThreadded(&testUnlockedLatch, (void*) l));
+	}
+
+	TEST_F(LatchTest, UnlocksSharedBesideUpdate) {
+		l->lockUpdate();
+
+		// The update latch must survive the release of other readers
+		EXPECT_EQ(0, testThreadded(&testSharedLatch, (void*) l));
+		EXPECT_EQ(0, testThreadded(&testUpdateLatch, (void*) l));
+		l->unlock();
+	}
+
+
+	/**
+	 * Shared state of a lock benchmark run.
+	 */
+	template<typename L>
+	struct LockBenchmark {
+		L lock;
+		unsigned writePercent;
+		uint64_t value = 0;
+		uint64_t writes[LOCK_BENCHMARK_THREADS] = {};
+	};
+
+	template<typename L>
+	struct LockBenchmarkThread {
+		LockBenchmark<L>* benchmark;
+		unsigned index;
+	};
+
+	template<typename L>
+	void* runLockBenchmark(void* arg) {
+		auto thread = (LockBenchmarkThread<L>*) arg;
+		auto benchmark = thread->benchmark;
+		unsigned seed = thread->index;
+		uint64_t sum = 0;
+
+		for (unsigned i = 0; i < LOCK_BENCHMARK_OPS; ++i) {
+			bool exclusive = (unsigned) rand_r(&seed) % 100 < benchmark->writePercent;
+
+			benchmark->lock.lock(exclusive);
+			if (exclusive) {
+				benchmark->value++;
+				benchmark->writes[thread->index]++;
+			} else {
+				sum += benchmark->value;
+			}
+			benchmark->lock.unlock();
+		}
+
+		return (void*) (uintptr_t) sum;
+	}
+
+	/**
+	 * Runs @c LOCK_BENCHMARK_THREADS threads acquiring the lock in a loop,
+	 * exclusively with the given probability, and returns the number of
+	 * operations per millisecond.
+	 */
+	template<typename L>
+	double benchmarkLock(unsigned writePercent) {
+		LockBenchmark<L> benchmark;
+		benchmark.writePercent = writePercent;
+
+		pthread_t threads[LOCK_BENCHMARK_THREADS];
+		LockBenchmarkThread<L> args[LOCK_BENCHMARK_THREADS];
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < LOCK_BENCHMARK_THREADS; ++i) {
+			args[i] = { &benchmark, i };
+			pthread_create(&threads[i], nullptr, &runLockBenchmark<L>, &args[i]);
+		}
+
+		for (unsigned i = 0; i < LOCK_BENCHMARK_THREADS; ++i)
+			pthread_join(threads[i], nullptr);
+		auto end = std::chrono::steady_clock::now();
+
+		// Exclusive sections must not have lost any update
+		uint64_t writes = 0;
+		for (unsigned i = 0; i < LOCK_BENCHMARK_THREADS; ++i)
+			writes += benchmark.writes[i];
+		EXPECT_EQ(writes, benchmark.value);
+
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		return LOCK_BENCHMARK_THREADS * LOCK_BENCHMARK_OPS / ms;
+	}
+
+	void compareLocks(const char* name, unsigned writePercent) {
+		double lock = benchmarkLock<Lock>(writePercent);
+		double latch = benchmarkLock<Latch>(writePercent);
+
+		std::cout << "[ BENCH    ] " << name << " (" << writePercent << "% writes): "
+			<< "Lock " << (uint64_t) lock << " ops/ms, "
+			<< "Latch " << (uint64_t) latch << " ops/ms" << std::endl;
+	}
+
+	TEST(LockBenchmarkTest, ReaderHeavy) {
+		compareLocks("ReaderHeavy", 1);
+	}
+
+	TEST(LockBenchmarkTest, Mixed) {
+		compareLocks("Mixed", 50);
+	}
+
 }
 }
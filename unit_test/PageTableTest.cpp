@@ -0,0 +1,99 @@
+//
+//  PageTableTest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "buffer/FrameArena.h"
+#include "buffer/PageTable.h"
+
+#define TEST_PAGE_TABLE_FRAMES 4096
+
+namespace lsql {
+namespace test {
+
+	struct PageTableTest : public testing::Test {
+		FrameArena* arena;
+		File<void> file;
+
+		virtual void SetUp() {
+			arena = new FrameArena(TEST_PAGE_TABLE_FRAMES, false);
+		}
+
+		virtual void TearDown() {
+			delete arena;
+		}
+
+		/**
+		 * Assigns the frames to pages distributed over the given number of
+		 * segments and inserts them into the table.
+		 */
+		void fill(PageTable& table, uint16_t segments) {
+			for (uint64_t i = 0; i < arena->getCount(); ++i) {
+				BufferFrame& frame = arena->getFrame(i);
+				frame.reset(PID(uint16_t(i % segments), uint32_t(i / segments)), file);
+				table.getPartition(frame.getId()).insert(&frame);
+			}
+		}
+	};
+
+	TEST_F(PageTableTest, FindsInsertedFrames) {
+		PageTable table(arena->getCount());
+		fill(table, 16);
+
+		uint64_t size = 0;
+		for (uint64_t i = 0; i < table.getPartitionCount(); ++i)
+			size += table.getPartitionAt(i).getSize();
+		EXPECT_EQ(arena->getCount(), size);
+
+		for (uint64_t i = 0; i < arena->getCount(); ++i) {
+			BufferFrame& frame = arena->getFrame(i);
+			EXPECT_EQ(&frame, table.getPartition(frame.getId()).find(frame.getId()));
+		}
+
+		EXPECT_EQ(nullptr, table.getPartition(PID(16, 0)).find(PID(16, 0)));
+	}
+
+	TEST_F(PageTableTest, IgnoresTupleBits) {
+		PageTable table(arena->getCount());
+		fill(table, 16);
+
+		TID tid(3, 5, 7);
+		EXPECT_EQ(PID(3, 5), table.getPartition(tid).find(tid)->getId());
+	}
+
+	TEST_F(PageTableTest, GrowsPartitions) {
+		// All frames end up in a single partition
+		PageTable table(1);
+		fill(table, 4);
+
+		PageTable::Partition& partition = table.getPartitionAt(0);
+		EXPECT_EQ(arena->getCount(), partition.getSize());
+		EXPECT_GE(partition.getCapacity(), 2 * arena->getCount());
+
+		BufferFrame& frame = arena->getFrame(arena->getCount() - 1);
+		EXPECT_EQ(&frame, partition.find(frame.getId()));
+	}
+
+	TEST_F(PageTableTest, RemovesWithoutBreakingProbes) {
+		PageTable table(1);
+		fill(table, 4);
+
+		// Remove every other frame, the rest must still be reachable
+		PageTable::Partition& partition = table.getPartitionAt(0);
+		for (uint64_t i = 0; i < arena->getCount(); i += 2)
+			EXPECT_TRUE(partition.remove(&arena->getFrame(i)));
+
+		EXPECT_FALSE(partition.remove(&arena->getFrame(0)));
+		EXPECT_EQ(arena->getCount() / 2, partition.getSize());
+
+		for (uint64_t i = 0; i < arena->getCount(); ++i) {
+			BufferFrame& frame = arena->getFrame(i);
+			EXPECT_EQ(i % 2 ? &frame : nullptr, partition.find(frame.getId()));
+		}
+	}
+
+}
+}
@@ -0,0 +1,156 @@
+//
+//  ReplacementPolicyTest.cpp
+//  database
+//
+//  Created by agent on 17/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include "buffer/ArcPolicy.h"
+#include "buffer/ClockPolicy.h"
+#include "buffer/FrameArena.h"
+#include "buffer/LruKPolicy.h"
+#include "buffer/TwoQueuePolicy.h"
+
+namespace lsql {
+namespace test {
+
+	struct AcceptingEvictor : public FrameEvictor {
+		bool evictFrame(BufferFrame*) {
+			return true;
+		}
+	};
+
+	struct ReplacementPolicyTest : public testing::Test {
+		FrameArena* arena;
+		File<void> file;
+		AcceptingEvictor evictor;
+
+		virtual void SetUp() {
+			arena = new FrameArena(4, false);
+		}
+
+		virtual void TearDown() {
+			delete arena;
+		}
+
+		/**
+		 * Loads pages 0 to 3 into the frames and accesses page 0 again.
+		 */
+		void load(ReplacementPolicy& policy) {
+			for (uint32_t i = 0; i < 4; ++i) {
+				BufferFrame& frame = arena->getFrame(i);
+				frame.reset(PID(1, i), file);
+				policy.insert(&frame);
+			}
+
+			policy.access(&arena->getFrame(0));
+		}
+
+		/**
+		 * Returns the page of the next victim.
+		 */
+		uint32_t evict(ReplacementPolicy& policy) {
+			BufferFrame* frame = policy.evict(evictor);
+			EXPECT_NE(nullptr, frame);
+			EXPECT_EQ(QUEUE_NONE, frame->queue);
+			return frame->getId().page();
+		}
+	};
+
+	TEST_F(ReplacementPolicyTest, TwoQueueKeepsReaccessedPage) {
+		TwoQueuePolicy policy(4, 0.0);
+		load(policy);
+
+		EXPECT_EQ(1, evict(policy));
+		EXPECT_EQ(2, evict(policy));
+		EXPECT_EQ(3, evict(policy));
+		EXPECT_EQ(0, evict(policy));
+	}
+
+	TEST_F(ReplacementPolicyTest, TwoQueuePromotesOnEviction) {
+		TwoQueuePolicy policy(4, 0.0);
+		load(policy);
+
+		// Hits do not touch the queues
+		EXPECT_EQ(QUEUE_A1, arena->getFrame(0).queue);
+
+		EXPECT_EQ(1, evict(policy));
+		EXPECT_EQ(QUEUE_AM, arena->getFrame(0).queue);
+		EXPECT_FALSE(arena->getFrame(0).referenced);
+	}
+
+	TEST_F(ReplacementPolicyTest, ClockKeepsReferencedPage) {
+		ClockPolicy policy;
+		load(policy);
+
+		EXPECT_EQ(1, evict(policy));
+		EXPECT_EQ(2, evict(policy));
+	}
+
+	TEST_F(ReplacementPolicyTest, LruKKeepsReaccessedPage) {
+		LruKPolicy policy;
+		load(policy);
+
+		EXPECT_EQ(1, evict(policy));
+		EXPECT_EQ(2, evict(policy));
+		EXPECT_EQ(3, evict(policy));
+		EXPECT_EQ(0, evict(policy));
+	}
+
+	TEST_F(ReplacementPolicyTest, LruKOrdersByKthAccess) {
+		LruKPolicy policy;
+		load(policy);
+
+		// Page 0 is accessed last, but its second to last access is older
+		policy.access(&arena->getFrame(1));
+		policy.access(&arena->getFrame(1));
+		policy.access(&arena->getFrame(0));
+
+		EXPECT_EQ(2, evict(policy));
+		EXPECT_EQ(3, evict(policy));
+		EXPECT_EQ(0, evict(policy));
+		EXPECT_EQ(1, evict(policy));
+	}
+
+	TEST_F(ReplacementPolicyTest, ArcKeepsReaccessedPage) {
+		ArcPolicy policy(4);
+		load(policy);
+
+		EXPECT_EQ(1, evict(policy));
+		EXPECT_EQ(2, evict(policy));
+	}
+
+	TEST_F(ReplacementPolicyTest, ArcIgnoresTupleBitsOfGhosts) {
+		ArcPolicy policy(4);
+		load(policy);
+
+		BufferFrame* frame = policy.evict(evictor);
+		ASSERT_EQ(&arena->getFrame(1), frame);
+
+		// A ghost hit promotes the page to T2
+		frame->reset(TID(1, 1, 7), file);
+		policy.insert(frame);
+		EXPECT_EQ(QUEUE_AM, frame->queue);
+	}
+
+	TEST_F(ReplacementPolicyTest, SkipsFixedFrames) {
+		LruKPolicy policy;
+		load(policy);
+
+		arena->getFrame(1).fixCount++;
+		EXPECT_EQ(2, evict(policy));
+		arena->getFrame(1).fixCount--;
+	}
+
+	TEST_F(ReplacementPolicyTest, DiscardsOnlyUnaccessedPages) {
+		ArcPolicy policy(4);
+		load(policy);
+
+		EXPECT_FALSE(policy.discard(&arena->getFrame(0), PID(1, 0), evictor));
+		EXPECT_FALSE(policy.discard(&arena->getFrame(1), PID(1, 2), evictor));
+		EXPECT_TRUE(policy.discard(&arena->getFrame(1), PID(1, 1), evictor));
+	}
+
+}
+}
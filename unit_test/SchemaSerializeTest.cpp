@@ -6,6 +6,9 @@
 //  Copyright (c) 2014 LightningSQL. All rights reserved.
 //
 
+#include <cstdio>
+#include <string>
+
 #include "gtest/gtest.h"
 #include "utils/Serialize.h"
 
@@ -24,3 +27,88 @@ TEST(Serialization, Number) {
 		if (t1!=t2) { std::cerr << "PROBLEMS!" << std::endl; }
 	}
 }
+
+#define TEST_SCHEMA_SEGMENT 913
+
+namespace lsql {
+namespace test {
+
+	Attribute makeAttribute(const std::string& name, uint32_t len) {
+		Attribute attribute;
+		attribute.name = name;
+		attribute.type = Type::Char;
+		attribute.len = len;
+		attribute.notNull = false;
+		return attribute;
+	}
+
+	struct SerializationTest : public testing::Test {
+		virtual void TearDown() {
+			remove(std::to_string(TEST_SCHEMA_SEGMENT).c_str());
+			remove((std::to_string(TEST_SCHEMA_SEGMENT) + ".fsm").c_str());
+		}
+	};
+
+	TEST_F(SerializationTest, Schema) {
+		BufferManager bm(1);
+
+		Schema schema;
+		schema.segmentCount = TEST_SCHEMA_SEGMENT + 1;
+		schema.relations.emplace_back(bm, TEST_SCHEMA_SEGMENT, 3);
+		schema.relations.back().name = "current";
+		schema.relations.back().primaryKey = { 0 };
+		schema.relations.back().attributes = { makeAttribute("id", 20) };
+
+		StreamType stream;
+		serialize(schema, stream);
+
+		serialization::BufferContext context(bm);
+		Schema result = deserialize<Schema, serialization::BufferContext>(stream, &context);
+
+		EXPECT_EQ(SCHEMA_VERSION, context.version);
+		EXPECT_EQ(schema.segmentCount, result.segmentCount);
+		ASSERT_EQ(1u, result.relations.size());
+
+		const Relation& relation = result.relations.front();
+		EXPECT_EQ(TEST_SCHEMA_SEGMENT, relation.segmentId());
+		EXPECT_EQ(3u, relation.pageCount());
+		EXPECT_EQ(uint32_t(BufferFrame::SIZE), relation.pageSize());
+		EXPECT_EQ("current", relation.name);
+		EXPECT_EQ(std::vector<unsigned>({ 0 }), relation.primaryKey);
+		ASSERT_EQ(1u, relation.attributes.size());
+		EXPECT_EQ("id", relation.attributes.front().name);
+		EXPECT_EQ(20u, relation.attributes.front().len);
+		EXPECT_FALSE(relation.attributes.front().notNull);
+	}
+
+	TEST_F(SerializationTest, LegacySchema) {
+		BufferManager bm(1);
+
+		// Catalog layout before the format tag and relation page sizes
+		StreamType stream;
+		serialize(uint16_t(TEST_SCHEMA_SEGMENT + 1), stream);
+		serialize(size_t(1), stream);
+		serialize(uint16_t(TEST_SCHEMA_SEGMENT), stream);
+		serialize(uint32_t(3), stream);
+		serialize(std::string("legacy"), stream);
+		serialize(std::vector<unsigned>({ 0 }), stream);
+		serialize(std::vector<Attribute>({ makeAttribute("id", 20) }), stream);
+
+		serialization::BufferContext context(bm);
+		Schema result = deserialize<Schema, serialization::BufferContext>(stream, &context);
+
+		EXPECT_EQ(SCHEMA_VERSION_LEGACY, context.version);
+		EXPECT_EQ(TEST_SCHEMA_SEGMENT + 1, result.segmentCount);
+		ASSERT_EQ(1u, result.relations.size());
+
+		const Relation& relation = result.relations.front();
+		EXPECT_EQ(TEST_SCHEMA_SEGMENT, relation.segmentId());
+		EXPECT_EQ(3u, relation.pageCount());
+		EXPECT_EQ(uint32_t(BufferFrame::SIZE), relation.pageSize());
+		EXPECT_EQ("legacy", relation.name);
+		ASSERT_EQ(1u, relation.attributes.size());
+		EXPECT_EQ("id", relation.attributes.front().name);
+	}
+
+}
+}
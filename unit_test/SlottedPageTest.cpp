@@ -0,0 +1,142 @@
+//
+//  SlottedPageTest.cpp
+//  database
+//
+//  Created by agent on 18/10/26.
+//  Copyright (c) 2026 LightningSQL. All rights reserved.
+//
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+
+#include "buffer/BufferManager.h"
+#include "segment/SlottedPage.h"
+#include "segment/SPSegment.h"
+
+#define TEST_SLOTTED_SEGMENT 911
+#define TEST_SLOTTED_PAGE_SIZE SLOTTED_PAGE_PACKED_SIZE
+
+namespace lsql {
+namespace test {
+
+	/** Header of pages written before page format versions existed. */
+	struct LegacyHeader {
+		uint16_t count;
+		int32_t dataStart;
+		int32_t usedSpace;
+	};
+
+	/** Slot of pages written before page format versions existed. */
+	struct LegacySlot {
+		uint32_t type;
+		int32_t offset;
+		int32_t size;
+	};
+
+	struct SlottedPageTest : public testing::Test {
+		virtual void TearDown() {
+			remove(std::to_string(TEST_SLOTTED_SEGMENT).c_str());
+			remove((std::to_string(TEST_SLOTTED_SEGMENT) + ".fsm").c_str());
+		}
+	};
+
+	TEST_F(SlottedPageTest, PacksSlotsOfSmallPages) {
+		BufferManager bm(4);
+		SPSegment segment(bm, TEST_SLOTTED_SEGMENT);
+
+		uint64_t value = 0;
+		TID id = segment.insert(Record(sizeof(value), reinterpret_cast<char*>(&value)));
+		while (id.page() == 0) {
+			++value;
+			id = segment.insert(Record(sizeof(value), reinterpret_cast<char*>(&value)));
+		}
+
+		// More records fit than with twelve byte slots
+		EXPECT_LT((BufferFrame::SIZE - sizeof(LegacyHeader)) / (sizeof(value) + sizeof(LegacySlot)), value);
+	}
+
+	TEST_F(SlottedPageTest, OpensFreeSpaceMapOnFirstInsert) {
+		BufferManager bm(4);
+		std::string map = std::to_string(TEST_SLOTTED_SEGMENT) + ".fsm";
+
+		SPSegment segment(bm, TEST_SLOTTED_SEGMENT);
+		EXPECT_NE(0, access(map.c_str(), F_OK));
+
+		uint64_t value = 42;
+		TID first = segment.insert(Record(sizeof(value), reinterpret_cast<char*>(&value)));
+		EXPECT_EQ(0, access(map.c_str(), F_OK));
+
+		// The moved segment keeps the open map instead of creating it again
+		remove(map.c_str());
+		SPSegment moved(std::move(segment));
+		TID second = moved.insert(Record(sizeof(value), reinterpret_cast<char*>(&value)));
+		EXPECT_EQ(first.page(), second.page());
+		EXPECT_NE(0, access(map.c_str(), F_OK));
+	}
+
+	TEST_F(SlottedPageTest, ReadsLegacyPages) {
+		BufferManager bm(4);
+
+		// Write a page in the old format, whose header padding is garbage
+		BufferFrame& frame = bm.fixPage(PID(TEST_SLOTTED_SEGMENT, 0), true);
+		char* data = static_cast<char*>(frame.getData());
+		std::memset(data, 0xAB, BufferFrame::SIZE);
+
+		LegacyHeader header;
+		std::memset(&header, 0xAB, sizeof(header));
+		header.count = 3;
+		header.dataStart = int32_t(BufferFrame::SIZE) - 10;
+		header.usedSpace = 10;
+		std::memcpy(data, &header, sizeof(header));
+
+		LegacySlot slots[3] = {{1, header.dataStart, 5}, {0, 0, 0}, {1, header.dataStart + 5, 5}};
+		std::memcpy(data + sizeof(header), slots, sizeof(slots));
+		std::memcpy(data + header.dataStart, "firstthird", 10);
+		bm.unfixPage(frame, true);
+
+		SPSegment segment(bm, TEST_SLOTTED_SEGMENT, 1);
+		Record first = segment.lookup(TID(TEST_SLOTTED_SEGMENT, 0, 0));
+		EXPECT_EQ(std::string("first"), std::string(first.getData(), first.getSize()));
+		Record third = segment.lookup(TID(TEST_SLOTTED_SEGMENT, 0, 2));
+		EXPECT_EQ(std::string("third"), std::string(third.getData(), third.getSize()));
+
+		// The first insert upgrades the page and reuses its empty slot
+		TID id = segment.insert(Record(6, "second"));
+		EXPECT_EQ(TID(TEST_SLOTTED_SEGMENT, 0, 1), id);
+		Record second = segment.lookup(id);
+		EXPECT_EQ(std::string("second"), std::string(second.getData(), second.getSize()));
+
+		segment.remove(TID(TEST_SLOTTED_SEGMENT, 0, 2));
+		Record kept = segment.lookup(TID(TEST_SLOTTED_SEGMENT, 0, 0));
+		EXPECT_EQ(std::string("first"), std::string(kept.getData(), kept.getSize()));
+	}
+
+	TEST_F(SlottedPageTest, PacksSlotsOfLargestPages) {
+		// The default pool may already hold pages of this size
+		BufferOptions options;
+		if (BufferFrame::SIZE != TEST_SLOTTED_PAGE_SIZE)
+			options.pools.push_back(PoolOptions{ TEST_SLOTTED_PAGE_SIZE, 2 });
+
+		BufferManager bm(4, options);
+		ASSERT_TRUE(bm.setPageSize(TEST_SLOTTED_SEGMENT, TEST_SLOTTED_PAGE_SIZE));
+		SPSegment segment(bm, TEST_SLOTTED_SEGMENT);
+
+		// Empty records on an empty page start at the very end of the page
+		TID empty = segment.insert(Record(0, ""));
+		EXPECT_EQ(0u, segment.lookup(empty).getSize());
+
+		std::string text(TEST_SLOTTED_PAGE_SIZE / 2, 'x');
+		TID full = segment.insert(Record(uint32_t(text.size()), text.c_str()));
+		EXPECT_EQ(empty.page(), full.page());
+
+		EXPECT_TRUE(segment.update(empty, Record(5, "empty")));
+		EXPECT_TRUE(segment.update(full, Record(0, "")));
+		Record updated = segment.lookup(empty);
+		EXPECT_EQ(std::string("empty"), std::string(updated.getData(), updated.getSize()));
+		EXPECT_EQ(0u, segment.lookup(full).getSize());
+	}
+
+}
+}
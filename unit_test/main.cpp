@@ -33,10 +33,20 @@
 #include "FileTest.cpp"
 #include "LockTest.cpp"
 #include "MutexTest.cpp"
+#include "ConditionTest.cpp"
 #include "ConcurrentListTest.cpp"
+#include "BitmapTest.cpp"
 #include "IdTest.cpp"
 #include "BufferFrameTest.cpp"
+#include "BufferRingTest.cpp"
+#include "BufferStatsTest.cpp"
+#include "FrameArenaTest.cpp"
+#include "PageTableTest.cpp"
+#include "ReplacementPolicyTest.cpp"
 #include "BufferManagerTest.cpp"
+#include "FreeSpaceMapTest.cpp"
+#include "SlottedPageTest.cpp"
+#include "BTreeTest.cpp"
 #include "SerializeTest.cpp"
 #include "SchemaSerializeTest.cpp"
 